@@ -0,0 +1,145 @@
+#include "../include/strategy_engine.h"
+#include "../include/static_pipeline.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <algorithm>
+
+// Checks that tick dispatch does not allocate once warmed up. Global
+// operator new is replaced with a counting version; each dispatch path runs
+// a warm-up pass, the counter is reset and a second pass over the same
+// ticks must allocate nothing. Covers the serial StrategyEngine (per tick
+// and batched), the pooled StrategyEngine and a StaticPipeline, all with
+// strategies that emit through SignalSink. Exits nonzero on any
+// steady-state allocation.
+//
+// Usage: allocation_check [ticks] [pool threads]
+
+namespace {
+std::atomic<uint64_t> allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr size_t INSTRUMENTS = 10;
+constexpr size_t BATCH = 64;
+
+std::vector<Tick> generateTicks(size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<int32_t> mids(INSTRUMENTS, 100000);
+    std::vector<Tick> ticks(count);
+    for (Tick& tick : ticks) {
+        size_t index = rng() % INSTRUMENTS;
+        mids[index] += static_cast<int32_t>(rng() % 21) - 10;
+        tick = Tick{};
+        tick.instrument_id = static_cast<InstrumentId>(index + 1);
+        tick.bid_price = Price(mids[index] - 1);
+        tick.ask_price = Price(mids[index] + 1);
+        tick.bid_size = Quantity(100);
+        tick.ask_size = Quantity(100);
+    }
+    return ticks;
+}
+
+// Runs dispatch twice over the ticks and reports the second pass
+template <typename Dispatch>
+bool check(const char* name, Dispatch dispatch, const uint64_t& signals) {
+    dispatch();
+    uint64_t warm_signals = signals;
+    allocations.store(0, std::memory_order_relaxed);
+    dispatch();
+    uint64_t counted = allocations.load(std::memory_order_relaxed);
+
+    std::cout << std::left << std::setw(30) << name << std::right
+              << std::setw(12) << signals - warm_signals << std::setw(14) << counted
+              << (counted == 0 ? "  ok" : "  FAILED") << std::endl;
+    return counted == 0;
+}
+
+bool checkEngine(const char* name, size_t threads, bool batched, const std::vector<Tick>& ticks) {
+    uint64_t signals = 0;
+    StrategyEngine engine(threads);
+    engine.initialize([&signals](const Order&) { ++signals; });
+    for (InstrumentId id = 1; id <= INSTRUMENTS; ++id) {
+        engine.registerStrategy(std::make_unique<SimpleMeanReversionStrategy>(id, 0.0005));
+    }
+    engine.start();
+
+    bool ok = check(name, [&] {
+        if (batched) {
+            for (size_t i = 0; i < ticks.size(); i += BATCH) {
+                engine.processTicks(ticks.data() + i, std::min(BATCH, ticks.size() - i));
+            }
+        } else {
+            for (const Tick& tick : ticks) {
+                engine.processTick(tick);
+            }
+        }
+    }, signals);
+
+    engine.stop();
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 640000;
+    size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2;
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    std::vector<Tick> ticks = generateTicks(count);
+    std::cout << count << " ticks, " << INSTRUMENTS << " mean-reversion strategies" << std::endl;
+    std::cout << std::left << std::setw(30) << "path" << std::right
+              << std::setw(12) << "signals" << std::setw(14) << "allocations" << std::endl;
+
+    bool ok = true;
+    ok &= checkEngine("engine serial processTick", 0, false, ticks);
+    ok &= checkEngine("engine serial processTicks", 0, true, ticks);
+    ok &= checkEngine("engine pooled processTicks", threads, true, ticks);
+
+    uint64_t signals = 0;
+    auto pipeline = makeStaticPipeline([&signals](const Order&) { ++signals; },
+                                       SimpleMeanReversionStrategy(1, 0.0005), SimpleMeanReversionStrategy(2, 0.0005),
+                                       SimpleMeanReversionStrategy(3, 0.0005), SimpleMeanReversionStrategy(4, 0.0005));
+    ok &= check("StaticPipeline processTick", [&] {
+        for (const Tick& tick : ticks) {
+            pipeline.processTick(tick);
+        }
+    }, signals);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include "../include/clock.h"
+#include "../include/config.h"
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+
+// Checks that the TSC clock tracks CLOCK_REALTIME while the background
+// recalibration runs: Clock::now() must never step backwards and, after the
+// first recalibration, must stay within a bound of realtime. Exits nonzero
+// if either fails.
+//
+// Usage: clock_drift_check [seconds] [max drift in us] [recalibration interval in ms]
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    int64_t max_drift_ns = static_cast<int64_t>((argc > 2 ? std::atof(argv[2]) : 100.0) * 1000.0);
+    int64_t interval_ms = argc > 3 ? std::atoll(argv[3]) : 100;
+
+    // Must be set before the clock calibrates on first use
+    ConfigManager::getInstance().clock_recalibration_interval_ms = interval_ms;
+    if (!Clock::usingTsc()) {
+        std::cout << "No invariant TSC, Clock::now() reads CLOCK_REALTIME directly" << std::endl;
+        return 0;
+    }
+
+    Timestamp start = Clock::realtimeNow();
+    Timestamp settle = start + static_cast<Timestamp>(interval_ms) * 1000000ULL * 2;
+    Timestamp end = start + static_cast<Timestamp>(seconds * 1e9);
+
+    Timestamp previous = Clock::now();
+    uint64_t samples = 0;
+    uint64_t backwards = 0;
+    int64_t worst_drift = 0;
+    for (Timestamp realtime = start; realtime < end;) {
+        // Bracket the reading so scheduling between the two calls is not counted as drift
+        Timestamp before = Clock::realtimeNow();
+        Timestamp now = Clock::now();
+        realtime = Clock::realtimeNow();
+
+        if (now < previous) {
+            backwards++;
+        }
+        previous = now;
+
+        if (before >= settle && realtime - before < 10000) {
+            int64_t drift = 0;
+            if (now < before) {
+                drift = static_cast<int64_t>(before - now);
+            } else if (now > realtime) {
+                drift = static_cast<int64_t>(now - realtime);
+            }
+            worst_drift = std::max(worst_drift, drift);
+            samples++;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    std::cout << "TSC " << Clock::getTscFrequencyGhz() << " GHz, recalibrating every " << interval_ms << " ms" << std::endl;
+    std::cout << samples << " samples over " << seconds << " s, worst drift " << worst_drift
+              << " ns (limit " << max_drift_ns << "), " << backwards << " backward steps" << std::endl;
+
+    if (backwards > 0 || worst_drift > max_drift_ns) {
+        std::cout << "FAILED" << std::endl;
+        return 1;
+    }
+    return 0;
+}
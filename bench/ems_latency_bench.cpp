@@ -0,0 +1,109 @@
+#include "../include/execution_management_system.h"
+#include "../include/clock.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+// Enqueue-to-ack latency of the EMS send path under each wait strategy.
+// One order is in flight at a time: the producer stamps it, queues it with
+// sendOrderToMarket() and waits for the send worker's acknowledgment, whose
+// callback records the time since the stamp. Run on an otherwise idle
+// machine with at least three cores, since both EMS workers and the
+// producer may spin.
+//
+// Usage: ems_latency_bench [orders per strategy] [seconds per strategy]
+
+namespace {
+
+const char* strategyName(WaitStrategy strategy) {
+    switch (strategy) {
+        case WaitStrategy::BUSY_POLL: return "busy-poll";
+        case WaitStrategy::SPIN_THEN_YIELD: return "spin-then-yield";
+        case WaitStrategy::SPIN_THEN_PARK: return "spin-then-park";
+    }
+    return "unknown";
+}
+
+int64_t percentile(const std::vector<int64_t>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1));
+    return sorted[index];
+}
+
+void run(WaitStrategy strategy, size_t orders, int64_t budget_ns) {
+    ConfigManager::getInstance().execution_wait_strategy = strategy;
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(orders);
+    std::atomic<uint64_t> acked{0};
+
+    ExecutionManagementSystem ems;
+    ems.initialize([&](const Order& order) {
+        latencies.push_back(static_cast<int64_t>(Clock::now() - order.timestamp));
+        acked.store(order.order_id, std::memory_order_release);
+    });
+    ems.start();
+
+    Order order{};
+    order.instrument_id = 1;
+    order.type = OrderType::LIMIT;
+    order.side = OrderSide::BUY;
+    order.price = Price(10000);
+    order.quantity = Quantity(1);
+    order.market = Market::USA_NYSE;
+
+    Timestamp deadline = Clock::now() + static_cast<Timestamp>(budget_ns);
+    for (OrderId id = 1; id <= orders && Clock::now() < deadline; ++id) {
+        order.order_id = id;
+        order.timestamp = Clock::now();
+        if (!ems.sendOrderToMarket(order)) {
+            break;
+        }
+
+        // Spin briefly, then yield so a worker sharing our core can run
+        for (uint32_t spins = 0; acked.load(std::memory_order_acquire) != id; ++spins) {
+            if (spins < 100) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    ems.stop();
+
+    if (latencies.empty()) {
+        std::cout << std::left << std::setw(18) << strategyName(strategy) << "no orders completed" << std::endl;
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::left << std::setw(18) << strategyName(strategy) << std::right
+              << std::setw(10) << latencies.size()
+              << std::setw(10) << percentile(latencies, 0.50)
+              << std::setw(10) << percentile(latencies, 0.99)
+              << std::setw(10) << percentile(latencies, 0.999)
+              << std::setw(12) << latencies.back() << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 5.0;
+    int64_t budget_ns = static_cast<int64_t>(seconds * 1e9);
+
+    std::cout << "EMS enqueue-to-ack latency in ns, " << std::thread::hardware_concurrency() << " cores" << std::endl;
+    std::cout << std::left << std::setw(18) << "strategy" << std::right
+              << std::setw(10) << "orders"
+              << std::setw(10) << "p50"
+              << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9"
+              << std::setw(12) << "max" << std::endl;
+
+    for (WaitStrategy strategy : {WaitStrategy::BUSY_POLL, WaitStrategy::SPIN_THEN_YIELD, WaitStrategy::SPIN_THEN_PARK}) {
+        run(strategy, orders, budget_ns);
+    }
+    return 0;
+}
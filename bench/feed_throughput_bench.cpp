@@ -0,0 +1,166 @@
+#include "../include/market_data_feed.h"
+#include "../include/clock.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+
+// Decode throughput of MarketDataFeed replaying a pcap capture. The capture
+// is generated first with FeedPacketBuilder and PcapWriter: an order-by-order
+// stream over a set of instruments (adds, partial cancels, executions,
+// deletes, replaces and some quotes) that keeps a few hundred orders live
+// per book, packed into full packets. Each pass replays the whole file
+// through a fresh feed on the calling thread with poll().
+//
+// Usage: feed_throughput_bench [messages] [instruments] [passes] [capture path]
+
+namespace {
+
+struct LiveOrder {
+    uint64_t ref;
+    Quantity remaining;
+};
+
+class CaptureGenerator {
+public:
+    CaptureGenerator(PcapWriter& writer, size_t instruments)
+        : writer_(writer), books_(instruments), rng_(42) {}
+
+    // Append one message, flushing the packet when it is full
+    void next() {
+        InstrumentId instrument_id = static_cast<InstrumentId>(rng_() % books_.size());
+        std::vector<LiveOrder>& live = books_[instrument_id];
+        timestamp_ += 100;
+
+        unsigned roll = rng_() % 100;
+        if (live.size() < 16 || (roll < 30 && live.size() < 512)) {
+            OrderSide side = (rng_() & 1) ? OrderSide::BUY : OrderSide::SELL;
+            int32_t offset = static_cast<int32_t>(rng_() % 50) + 1;
+            Price price(10000 + (side == OrderSide::BUY ? -offset : offset));
+            Quantity quantity(static_cast<Quantity::Rep>(rng_() % 10 + 1) * 100);
+            uint64_t ref = ++last_ref_;
+            emit([&] { return builder_.addOrder(instrument_id, ref, side, price, quantity, timestamp_); });
+            live.push_back({ref, quantity});
+            return;
+        }
+
+        size_t index = rng_() % live.size();
+        LiveOrder& order = live[index];
+        if (roll < 45 && order.remaining.count() > 100) {
+            emit([&] { return builder_.orderCancel(instrument_id, order.ref, Quantity(100), timestamp_); });
+            order.remaining = Quantity(order.remaining.count() - 100);
+        } else if (roll < 60 && order.remaining.count() > 100) {
+            emit([&] { return builder_.orderExecuted(instrument_id, order.ref, Quantity(100), timestamp_); });
+            order.remaining = Quantity(order.remaining.count() - 100);
+        } else if (roll < 70) {
+            uint64_t ref = ++last_ref_;
+            Price price(10000 + static_cast<int32_t>(rng_() % 100) - 50);
+            emit([&] { return builder_.orderReplace(instrument_id, order.ref, ref, price, order.remaining, timestamp_); });
+            order.ref = ref;
+        } else if (roll < 75) {
+            Tick tick{};
+            tick.instrument_id = instrument_id;
+            tick.bid_price = Price(9999);
+            tick.ask_price = Price(10001);
+            tick.bid_size = Quantity(100);
+            tick.ask_size = Quantity(100);
+            emit([&] { return builder_.quote(tick, timestamp_); });
+        } else {
+            emit([&] { return builder_.orderDelete(instrument_id, order.ref, timestamp_); });
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+
+    void finish() {
+        if (builder_.getMessageCount() > 0) {
+            flush();
+        }
+    }
+
+    size_t getPackets() const { return packets_; }
+
+private:
+    template <typename Append>
+    void emit(Append append) {
+        if (!append()) {
+            flush();
+            append();
+        }
+    }
+
+    void flush() {
+        writer_.write(builder_.data(), builder_.size(), timestamp_);
+        sequence_ += builder_.getMessageCount();
+        builder_.begin(sequence_);
+        packets_++;
+    }
+
+    PcapWriter& writer_;
+    FeedPacketBuilder builder_;
+    std::vector<std::vector<LiveOrder>> books_;
+    std::mt19937_64 rng_;
+    uint64_t last_ref_{0};
+    uint64_t sequence_{1};
+    Timestamp timestamp_{1700000000000000000ULL};
+    size_t packets_{0};
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    size_t instruments = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    int passes = argc > 3 ? std::atoi(argv[3]) : 3;
+    std::string path = argc > 4 ? argv[4] : "feed_throughput_bench.pcap";
+    if (instruments == 0) {
+        instruments = 1;
+    }
+
+    PcapWriter writer;
+    if (!writer.open(path)) {
+        std::cerr << "Cannot write capture " << path << std::endl;
+        return 1;
+    }
+    CaptureGenerator generator(writer, instruments);
+    for (size_t i = 0; i < messages; ++i) {
+        generator.next();
+    }
+    generator.finish();
+    writer.close();
+
+    std::cout << "Replaying " << messages << " messages in " << generator.getPackets() << " packets over "
+              << instruments << " instruments" << std::endl;
+    std::cout << std::left << std::setw(8) << "pass" << std::right
+              << std::setw(14) << "msgs/s" << std::setw(10) << "ns/msg"
+              << std::setw(10) << "errors" << std::setw(12) << "ticks" << std::endl;
+
+    for (int pass = 1; pass <= passes; ++pass) {
+        uint64_t ticks = 0;
+        MarketDataFeed feed(Market::USA_NYSE, [&](const Tick&) {
+            ++ticks;
+            return true;
+        });
+        if (!feed.openFile(path)) {
+            std::cerr << "Cannot replay capture " << path << std::endl;
+            return 1;
+        }
+
+        Timestamp start = Clock::now();
+        while (feed.poll() > 0) {
+        }
+        Timestamp elapsed = Clock::now() - start;
+
+        uint64_t decoded = feed.getMessagesDecoded();
+        double seconds = static_cast<double>(elapsed) / 1e9;
+        std::cout << std::left << std::setw(8) << pass << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << decoded / seconds
+                  << std::setprecision(1) << std::setw(10) << static_cast<double>(elapsed) / decoded
+                  << std::setw(10) << feed.getDecodeErrors() << std::setw(12) << ticks << std::endl;
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
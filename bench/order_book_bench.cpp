@@ -0,0 +1,179 @@
+#include "../include/order_book.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+// Update rate of a single OrderBook. An event stream is generated up front
+// (adds clustered near the touch, partial reductions, replaces and deletes,
+// holding a steady number of live orders) and then applied in a tight loop,
+// with a tick callback attached as the feed would. The L2 run sets
+// aggregated levels near the touch instead.
+//
+// Usage: order_book_bench [events] [live orders] [passes]
+
+namespace {
+
+enum class EventType : uint8_t { ADD, REDUCE, REPLACE, DELETE };
+
+struct Event {
+    EventType type;
+    OrderSide side;
+    uint64_t order_ref;
+    uint64_t new_order_ref;
+    Price price;
+    Quantity quantity;
+};
+
+struct LiveOrder {
+    uint64_t ref;
+    OrderSide side;
+    Quantity remaining;
+};
+
+constexpr int32_t MID = 100000;
+
+// Offset from the mid in ticks, most of it within a few ticks of the touch
+int32_t distanceFromMid(std::mt19937_64& rng) {
+    std::geometric_distribution<int32_t> distance(0.2);
+    return 1 + std::min<int32_t>(distance(rng), 500);
+}
+
+std::vector<Event> generateL3(size_t count, size_t live_target) {
+    std::mt19937_64 rng(42);
+    std::vector<Event> events;
+    events.reserve(count);
+    std::vector<LiveOrder> live;
+    uint64_t last_ref = 0;
+
+    while (events.size() < count) {
+        unsigned roll = rng() % 100;
+        if (live.size() < live_target / 2 || (roll < 40 && live.size() < live_target * 2)) {
+            Event event{};
+            event.type = EventType::ADD;
+            event.side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+            event.order_ref = ++last_ref;
+            int32_t offset = distanceFromMid(rng);
+            event.price = Price(MID + (event.side == OrderSide::BUY ? -offset : offset));
+            event.quantity = Quantity(static_cast<Quantity::Rep>(rng() % 10 + 1));
+            events.push_back(event);
+            live.push_back({event.order_ref, event.side, event.quantity});
+            continue;
+        }
+
+        size_t index = rng() % live.size();
+        LiveOrder& order = live[index];
+        Event event{};
+        event.order_ref = order.ref;
+        if (roll < 60 && order.remaining.count() > 1) {
+            event.type = EventType::REDUCE;
+            event.quantity = Quantity(1);
+            order.remaining = Quantity(order.remaining.count() - 1);
+        } else if (roll < 70) {
+            // A replace keeps the side, so reprice on the same side of the mid
+            event.type = EventType::REPLACE;
+            event.new_order_ref = ++last_ref;
+            int32_t offset = distanceFromMid(rng);
+            event.price = Price(MID + (order.side == OrderSide::BUY ? -offset : offset));
+            event.quantity = order.remaining;
+            order.ref = event.new_order_ref;
+        } else {
+            event.type = EventType::DELETE;
+            live[index] = live.back();
+            live.pop_back();
+        }
+        events.push_back(event);
+    }
+    return events;
+}
+
+double runL3(const std::vector<Event>& events, size_t live_target, uint64_t& ticks) {
+    OrderBook book(1, Price(MID - 2048), 4096, live_target * 4);
+    book.setTickCallback([&](const Tick&) { ++ticks; });
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Event& event : events) {
+        switch (event.type) {
+            case EventType::ADD:
+                book.addOrder(event.order_ref, event.side, event.price, event.quantity);
+                break;
+            case EventType::REDUCE:
+                book.reduceOrder(event.order_ref, event.quantity);
+                break;
+            case EventType::REPLACE:
+                book.replaceOrder(event.order_ref, event.new_order_ref, event.price, event.quantity);
+                break;
+            case EventType::DELETE:
+                book.deleteOrder(event.order_ref);
+                break;
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    if (book.getUpdatesRejected() > 0) {
+        std::cerr << book.getUpdatesRejected() << " L3 updates rejected" << std::endl;
+    }
+    return static_cast<double>(elapsed.count());
+}
+
+double runL2(size_t count, uint64_t& ticks) {
+    std::mt19937_64 rng(42);
+    std::vector<Event> events(count);
+    for (Event& event : events) {
+        event.side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+        int32_t offset = distanceFromMid(rng);
+        event.price = Price(MID + (event.side == OrderSide::BUY ? -offset : offset));
+        // Empty a level now and then so the best price has to be re-found
+        event.quantity = Quantity(static_cast<Quantity::Rep>(rng() % 8 == 0 ? 0 : rng() % 100 + 1));
+    }
+
+    OrderBook book(1, Price(MID - 2048), 4096, 16);
+    book.setTickCallback([&](const Tick&) { ++ticks; });
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Event& event : events) {
+        book.setLevel(event.side, event.price, event.quantity);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    return static_cast<double>(elapsed.count());
+}
+
+void report(const char* name, int pass, size_t events, double elapsed_ns, uint64_t ticks) {
+    std::cout << std::left << std::setw(6) << name << std::setw(6) << pass << std::right
+              << std::fixed << std::setprecision(0)
+              << std::setw(14) << events / (elapsed_ns / 1e9)
+              << std::setprecision(1) << std::setw(10) << elapsed_ns / events
+              << std::setw(12) << ticks << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t live_target = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    int passes = argc > 3 ? std::atoi(argv[3]) : 3;
+    if (live_target == 0) {
+        live_target = 1;
+    }
+
+    std::vector<Event> events = generateL3(count, live_target);
+
+    std::cout << count << " events per pass, about " << live_target << " live orders" << std::endl;
+    std::cout << std::left << std::setw(6) << "book" << std::setw(6) << "pass" << std::right
+              << std::setw(14) << "updates/s" << std::setw(10) << "ns/update" << std::setw(12) << "ticks" << std::endl;
+
+    for (int pass = 1; pass <= passes; ++pass) {
+        uint64_t ticks = 0;
+        double elapsed = runL3(events, live_target, ticks);
+        report("L3", pass, events.size(), elapsed, ticks);
+    }
+    for (int pass = 1; pass <= passes; ++pass) {
+        uint64_t ticks = 0;
+        double elapsed = runL2(count, ticks);
+        report("L2", pass, count, elapsed, ticks);
+    }
+    return 0;
+}
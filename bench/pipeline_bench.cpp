@@ -0,0 +1,186 @@
+#include "../include/static_pipeline.h"
+#include "../include/strategy_engine.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <algorithm>
+
+// Tick -> strategies -> signal handler cost of a StaticPipeline against the
+// serial StrategyEngine, on two strategy sets: one mean-reversion strategy
+// per instrument plus an EMA crossover that takes every tick, and only
+// EMA crossovers. The engine routes each tick to the strategies of its
+// instrument and the wildcard ones; the static pipeline visits every
+// strategy. The engine is measured through both processTicks (batches) and
+// processTick.
+//
+// Usage: pipeline_bench [ticks] [passes]
+
+namespace {
+
+constexpr size_t INSTRUMENTS = 4;
+constexpr size_t BATCH = 64;
+
+// Wildcard strategy: trades the crossing of a fast and a slow EMA of the mid
+class EmaCrossoverStrategy final : public Strategy {
+public:
+    void onTick(const Tick& tick) override {
+        double mid = (tick.bid_price.count() + tick.ask_price.count()) / 2.0;
+        if (!seeded_) {
+            fast_ = slow_ = mid;
+            seeded_ = true;
+        }
+        fast_ += 0.2 * (mid - fast_);
+        slow_ += 0.02 * (mid - slow_);
+        instrument_id_ = tick.instrument_id;
+    }
+
+    void onOrderUpdate(const Order&) override {}
+
+    void emitSignals(SignalSink& sink) override {
+        bool above = fast_ > slow_;
+        if (above == above_) {
+            return;
+        }
+        above_ = above;
+
+        Order order{};
+        order.instrument_id = instrument_id_;
+        order.type = OrderType::MARKET;
+        order.side = above ? OrderSide::BUY : OrderSide::SELL;
+        order.quantity = Quantity(1);
+        sink.emit(order);
+    }
+
+    std::string getName() const override { return "EmaCrossover"; }
+    bool isActive() const override { return true; }
+
+private:
+    double fast_{0.0};
+    double slow_{0.0};
+    bool seeded_{false};
+    bool above_{false};
+    InstrumentId instrument_id_{0};
+};
+
+std::vector<Tick> generateTicks(size_t count, size_t instruments) {
+    std::mt19937_64 rng(42);
+    std::vector<int32_t> mids(instruments, 100000);
+    std::vector<Tick> ticks(count);
+    for (Tick& tick : ticks) {
+        size_t index = rng() % instruments;
+        mids[index] += static_cast<int32_t>(rng() % 21) - 10;
+        tick = Tick{};
+        tick.instrument_id = static_cast<InstrumentId>(index + 1);
+        tick.bid_price = Price(mids[index] - 1);
+        tick.ask_price = Price(mids[index] + 1);
+        tick.bid_size = Quantity(100);
+        tick.ask_size = Quantity(100);
+    }
+    return ticks;
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(32) << "path" << std::setw(6) << "pass" << std::right
+              << std::setw(12) << "ns/tick" << std::setw(12) << "signals" << std::endl;
+}
+
+void report(const char* name, int pass, size_t ticks, std::chrono::nanoseconds elapsed, uint64_t signals) {
+    std::cout << std::left << std::setw(32) << name << std::setw(6) << pass << std::right
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << static_cast<double>(elapsed.count()) / ticks
+              << std::setw(12) << signals << std::endl;
+}
+
+template <typename Fn>
+std::chrono::nanoseconds timed(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+// makePipeline(handler) builds the static pipeline; addStrategies(engine)
+// registers the same strategy set with the engine
+template <typename MakePipeline, typename AddStrategies>
+void runScenario(const std::vector<Tick>& ticks, int passes, MakePipeline makePipeline, AddStrategies addStrategies) {
+    for (int pass = 1; pass <= passes; ++pass) {
+        uint64_t signals = 0;
+        auto pipeline = makePipeline([&signals](const Order&) { ++signals; });
+        auto elapsed = timed([&] {
+            for (const Tick& tick : ticks) {
+                pipeline.processTick(tick);
+            }
+        });
+        report("StaticPipeline", pass, ticks.size(), elapsed, signals);
+    }
+
+    for (bool batched : {true, false}) {
+        for (int pass = 1; pass <= passes; ++pass) {
+            uint64_t signals = 0;
+            StrategyEngine engine(0);
+            engine.initialize([&signals](const Order&) { ++signals; });
+            addStrategies(engine);
+            engine.start();
+
+            auto elapsed = timed([&] {
+                if (batched) {
+                    for (size_t i = 0; i < ticks.size(); i += BATCH) {
+                        engine.processTicks(ticks.data() + i, std::min(BATCH, ticks.size() - i));
+                    }
+                } else {
+                    for (const Tick& tick : ticks) {
+                        engine.processTick(tick);
+                    }
+                }
+            });
+            engine.stop();
+            report(batched ? "StrategyEngine::processTicks" : "StrategyEngine::processTick", pass, ticks.size(),
+                   elapsed, signals);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    int passes = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::vector<Tick> ticks = generateTicks(count, INSTRUMENTS);
+    std::cout << count << " ticks over " << INSTRUMENTS << " instruments" << std::endl;
+
+    std::cout << std::endl << "Routed: a mean-reversion strategy per instrument and an EMA crossover" << std::endl;
+    printHeader();
+    runScenario(
+        ticks, passes,
+        [](auto handler) {
+            return makeStaticPipeline(handler,
+                                      SimpleMeanReversionStrategy(1, 0.0005), SimpleMeanReversionStrategy(2, 0.0005),
+                                      SimpleMeanReversionStrategy(3, 0.0005), SimpleMeanReversionStrategy(4, 0.0005),
+                                      EmaCrossoverStrategy());
+        },
+        [](StrategyEngine& engine) {
+            for (InstrumentId id = 1; id <= INSTRUMENTS; ++id) {
+                engine.registerStrategy(std::make_unique<SimpleMeanReversionStrategy>(id, 0.0005));
+            }
+            engine.registerStrategy(std::make_unique<EmaCrossoverStrategy>());
+        });
+
+    std::cout << std::endl << "Wildcard: five EMA crossovers that each take every tick" << std::endl;
+    printHeader();
+    runScenario(
+        ticks, passes,
+        [](auto handler) {
+            return makeStaticPipeline(handler, EmaCrossoverStrategy(), EmaCrossoverStrategy(), EmaCrossoverStrategy(),
+                                      EmaCrossoverStrategy(), EmaCrossoverStrategy());
+        },
+        [](StrategyEngine& engine) {
+            for (int i = 0; i < 5; ++i) {
+                engine.registerStrategy(std::make_unique<EmaCrossoverStrategy>());
+            }
+        });
+    return 0;
+}
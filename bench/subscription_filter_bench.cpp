@@ -0,0 +1,124 @@
+#include "../include/subscription_filter.h"
+#include "../include/config.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <unordered_set>
+#include <cstdlib>
+
+// Cost of the subscription check on the tick path: SubscriptionFilter
+// against the mutex-guarded unordered_set MarketDataHandler used before it.
+// A set of instruments is subscribed out of the SystemConfig::max_instruments
+// id space and a stream of tick ids, half of them subscribed, is looked up.
+// Each filter is measured alone and while a control thread keeps
+// subscribing and unsubscribing.
+//
+// Usage: subscription_filter_bench [subscribed instruments] [lookups]
+
+namespace {
+
+// The filter MarketDataHandler used before SubscriptionFilter
+class LockedSet {
+public:
+    bool contains(InstrumentId instrument_id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return set_.find(instrument_id) != set_.end();
+    }
+
+    bool add(InstrumentId instrument_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return set_.insert(instrument_id).second;
+    }
+
+    bool remove(InstrumentId instrument_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return set_.erase(instrument_id) > 0;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_set<InstrumentId> set_;
+};
+
+template <typename Filter>
+void run(const char* name, Filter& filter, const std::vector<InstrumentId>& subscribed,
+         const std::vector<InstrumentId>& ticks, bool churn) {
+    for (InstrumentId id : subscribed) {
+        filter.add(id);
+    }
+
+    // Flip extra instruments on and off, as subscription changes would
+    std::atomic<bool> stop{false};
+    std::thread control;
+    if (churn) {
+        control = std::thread([&] {
+            InstrumentId id = 1;
+            while (!stop.load(std::memory_order_relaxed)) {
+                filter.add(id);
+                filter.remove(id);
+                id = id % 1000 + 1;
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+            }
+        });
+    }
+
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (InstrumentId id : ticks) {
+        hits += filter.contains(id);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    stop = true;
+    if (control.joinable()) {
+        control.join();
+    }
+
+    std::cout << std::left << std::setw(24) << name << std::setw(10) << (churn ? "churn" : "idle") << std::right
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << static_cast<double>(elapsed.count()) / ticks.size()
+              << std::setw(12) << hits << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t subscriptions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000000;
+    size_t max_instruments = ConfigManager::getInstance().max_instruments;
+    if (subscriptions == 0) {
+        subscriptions = 1;
+    }
+
+    // Subscribed ids are spread over the id space, clear of the churned ones
+    std::mt19937_64 rng(42);
+    std::vector<InstrumentId> subscribed;
+    subscribed.reserve(subscriptions);
+    for (size_t i = 0; i < subscriptions; ++i) {
+        subscribed.push_back(static_cast<InstrumentId>(1001 + rng() % (max_instruments - 1001)));
+    }
+
+    std::vector<InstrumentId> ticks;
+    ticks.reserve(lookups);
+    for (size_t i = 0; i < lookups; ++i) {
+        ticks.push_back((rng() & 1) ? subscribed[rng() % subscribed.size()]
+                                    : static_cast<InstrumentId>(rng() % max_instruments));
+    }
+
+    std::cout << subscriptions << " subscribed of " << max_instruments << " ids, " << lookups << " lookups" << std::endl;
+    std::cout << std::left << std::setw(24) << "filter" << std::setw(10) << "control" << std::right
+              << std::setw(12) << "ns/lookup" << std::setw(12) << "hits" << std::endl;
+
+    for (bool churn : {false, true}) {
+        LockedSet locked;
+        run("mutex + unordered_set", locked, subscribed, ticks, churn);
+        SubscriptionFilter filter(max_instruments);
+        run("SubscriptionFilter", filter, subscribed, ticks, churn);
+    }
+    return 0;
+}
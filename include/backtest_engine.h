@@ -0,0 +1,133 @@
+#ifndef BACKTEST_ENGINE_H
+#define BACKTEST_ENGINE_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "common_types.h"
+#include "config.h"
+#include "strategy_engine.h"
+#include "risk_management.h"
+#include "last_value_cache.h"
+#include "instrument_table.h"
+
+class TickJournalReader;
+
+// Execution assumptions of a backtest
+struct BacktestConfig {
+    int64_t order_latency_ns = 50000;     // Signal to arrival at the simulated exchange
+    double slippage_bps = 0.5;            // Charged on the value of each fill; fill prices stay on the tick grid
+    double commission_per_share = 0.0;
+    RiskLimits risk_limits{1e9, 1e9, 1e12, 1e9, 1000000};
+};
+
+// Outcome of a backtest run
+struct BacktestStats {
+    uint64_t ticks_processed{0};
+    uint64_t signals{0};
+    uint64_t orders_rejected{0};       // Failed RiskManagement::checkOrder
+    uint64_t orders_unfilled{0};       // No quote, or a limit price the market never reached on arrival
+    uint64_t fills{0};
+    uint64_t closing_trades{0};        // Fills that reduced or flipped a position
+    uint64_t winning_trades{0};
+    uint64_t losing_trades{0};
+
+    double traded_value{0.0};
+    double commission{0.0};
+    double slippage{0.0};
+    double realized_pnl{0.0};          // Net of commission and slippage
+    double unrealized_pnl{0.0};        // Open positions at the last mid
+    double total_pnl{0.0};
+    double max_drawdown{0.0};          // Largest fall of total P&L from its running peak
+
+    Timestamp first_tick_time{0};
+    Timestamp last_tick_time{0};
+    double elapsed_seconds{0.0};       // Wall-clock run time
+    double ticks_per_second{0.0};      // Over all runs so far
+
+    double winRate() const { return closing_trades ? static_cast<double>(winning_trades) / closing_trades : 0.0; }
+};
+
+// Event-driven backtest. Recorded ticks drive the production StrategyEngine
+// and strategies; signals pass through a real RiskManagement and are filled
+// by a simulated exchange after a fixed latency, at the touch prevailing on
+// arrival, with slippage charged as a cost. Fills flow back as order updates to the strategies
+// and risk. Everything runs on the calling thread on simulated time: while
+// run() executes, Clock::now() on that thread returns the time of the tick
+// being processed, so nothing sleeps and timestamps and rate limits follow
+// the data. Quotes live in a private LastValueCache, which keeps concurrent
+// backtests and a live system apart.
+class BacktestEngine {
+public:
+    explicit BacktestEngine(const BacktestConfig& config = BacktestConfig());
+    ~BacktestEngine();
+
+    BacktestEngine(const BacktestEngine&) = delete;
+    BacktestEngine& operator=(const BacktestEngine&) = delete;
+
+    bool addStrategy(std::unique_ptr<Strategy> strategy);
+
+    // Replay ticks in order; state carries over between runs
+    BacktestStats run(const Tick* ticks, size_t count);
+    BacktestStats run(const TickJournalReader& journal);
+
+    // Statistics accumulated so far
+    BacktestStats getStats() const;
+
+    // Net position of an instrument in lots, 0 if never traded
+    int64_t getPosition(InstrumentId instrument_id) const;
+
+    StrategyEngine& getStrategyEngine() { return *strategy_engine_; }
+    RiskManagement& getRiskManagement() { return *risk_management_; }
+
+private:
+    struct PendingOrder {
+        Timestamp arrival_time;
+        Order order;
+    };
+
+    // Positions are kept exactly in lots and tick-lots; stats are in
+    // currency, converted with the instrument's spec
+    struct InstrumentState {
+        Tick quote{};
+        bool has_quote{false};
+        InstrumentSpec spec{0.0, 0.0};  // Cached on the first tick
+        Position position{};
+        double unrealized_pnl{0.0};     // Currency, as last added to the stats
+    };
+
+    // Advance simulated time to the tick and run it through the system
+    void processTick(const Tick& tick);
+
+    // Signal callback: risk check, then queue for the simulated exchange
+    void onSignal(const Order& signal);
+
+    // Execute queued orders that have reached the exchange by `time`
+    void executeArrivals(Timestamp time);
+    void fillOrder(Order& order);
+
+    // Position and P&L bookkeeping for one fill
+    void applyFill(InstrumentState& state, const Order& order);
+    void markPosition(InstrumentState& state);
+    void updateEquity();
+
+    BacktestConfig config_;
+
+    LastValueCache quotes_;
+    std::unique_ptr<RiskManagement> risk_management_;
+    std::unique_ptr<StrategyEngine> strategy_engine_;
+    InstrumentTable<InstrumentState> instruments_;
+
+    // Orders in flight; latency is constant so arrival order is FIFO
+    std::vector<PendingOrder> pending_;
+    size_t pending_head_{0};
+    std::vector<Order> rejected_;   // Risk rejections awaiting delivery to strategies
+
+    Timestamp now_{0};
+    OrderId next_order_id_{1};
+
+    BacktestStats stats_;
+    double peak_pnl_{0.0};
+};
+
+#endif // BACKTEST_ENGINE_H
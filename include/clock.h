@@ -0,0 +1,131 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "common_types.h"
+#include "seqlock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Wall-clock source for Timestamps. On CPUs with an invariant TSC the time
+// is derived from rdtsc scaled by a calibration against CLOCK_REALTIME, so a
+// reading costs a few nanoseconds and no vDSO call. A background thread
+// refreshes the calibration every SystemConfig::clock_recalibration_interval_ms
+// (never if that is 0 or less), so readers never pay for it. Without an
+// invariant TSC every reading falls back to clock_gettime(CLOCK_REALTIME).
+//
+// A thread can substitute simulated time (see SimulatedTime), which is how
+// backtests drive components that read Clock::now() without sleeping.
+class Clock {
+public:
+    // Nanoseconds since the Unix epoch, or this thread's simulated time
+    static Timestamp now() {
+        if (simulated_time_) {
+            return *simulated_time_;
+        }
+
+        State& state = instance();
+        if (!state.use_tsc) {
+            return realtimeNow();
+        }
+
+        Calibration calibration = state.calibration.load();
+        int64_t delta = static_cast<int64_t>(readTsc() - calibration.base_tsc);
+        if (delta < 0) {
+            delta = 0; // TSC read was reordered before a concurrent recalibration
+        }
+
+        return calibration.base_ns +
+               static_cast<uint64_t>((static_cast<unsigned __int128>(delta) * calibration.ns_per_tick_q32) >> 32);
+    }
+
+    // Direct CLOCK_REALTIME reading in nanoseconds since the Unix epoch
+    static Timestamp realtimeNow();
+
+    // Raw time stamp counter
+    static uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return realtimeNow();
+#endif
+    }
+
+    // Whether readings come from the TSC
+    static bool usingTsc() { return instance().use_tsc; }
+
+    // Measured TSC frequency, 0 when the TSC is not used
+    static double getTscFrequencyGhz();
+
+    // Refresh the calibration now, in addition to the background refresh
+    static void recalibrate() { instance().recalibrate(); }
+
+    // While alive, Clock::now() on the constructing thread returns *time.
+    // The owner advances the referenced value; scopes nest.
+    class SimulatedTime {
+    public:
+        explicit SimulatedTime(const Timestamp* time) : previous_(simulated_time_) { simulated_time_ = time; }
+        ~SimulatedTime() { simulated_time_ = previous_; }
+
+        SimulatedTime(const SimulatedTime&) = delete;
+        SimulatedTime& operator=(const SimulatedTime&) = delete;
+
+    private:
+        const Timestamp* previous_;
+    };
+
+    // Whether this thread is running on simulated time
+    static bool isSimulated() { return simulated_time_ != nullptr; }
+
+private:
+    // TSC to nanoseconds mapping: ns = base_ns + (tsc - base_tsc) * ns_per_tick_q32 / 2^32
+    struct Calibration {
+        uint64_t base_tsc;
+        uint64_t base_ns;
+        uint64_t ns_per_tick_q32;
+    };
+
+    struct State {
+        State();
+        ~State();
+        void recalibrate();
+
+        // Background refresh, one pass per interval until the state is destroyed
+        void recalibrationThread(std::chrono::milliseconds interval);
+
+        bool use_tsc{false};
+
+        // First calibration point, used as the long baseline for the rate
+        uint64_t origin_tsc{0};
+        uint64_t origin_ns{0};
+
+        // Time over which a fast clock is slowed back onto realtime: the
+        // background interval, or the time since the last calibration if
+        // there is no background thread
+        uint64_t slew_window_ns{0};
+
+        Seqlock<Calibration> calibration;
+        std::atomic<bool> recalibrating{false};
+
+        std::thread recalibration_thread;
+        std::mutex stop_mutex;
+        std::condition_variable stop_cv;
+        bool stopping{false};
+    };
+
+    static State& instance() {
+        static State state;
+        return state;
+    }
+
+    static inline thread_local const Timestamp* simulated_time_ = nullptr;
+};
+
+#endif // CLOCK_H
@@ -3,17 +3,20 @@
 
 #include <string>
 #include <cstdint>
-#include <chrono>
 #include <vector>
+#include <cstddef>
+#include "fixed_point.h"
 
 // Basic types
 using OrderId = uint64_t;
 using InstrumentId = uint64_t;
-using Price = double;
-using Quantity = double;
+using StrategyId = uint32_t;
 
-// Timestamp type for high-precision timing
-using Timestamp = std::chrono::high_resolution_clock::time_point;
+// Timestamp type for high-precision timing: nanoseconds since the Unix epoch
+using Timestamp = uint64_t;
+
+// Cache line size used to pad shared hot data and avoid false sharing
+constexpr size_t CACHE_LINE_SIZE = 64;
 
 // Market identifiers
 enum class Market : uint8_t {
@@ -51,16 +54,34 @@ enum class OrderState : uint8_t {
     EXPIRED = 7
 };
 
-// Market data structures
+// Behaviour of a bounded queue when a producer finds it full
+enum class OverflowPolicy : uint8_t {
+    BLOCK = 0,        // Producer waits until the consumer frees a slot
+    DROP_OLDEST = 1,  // Oldest queued element is discarded to make room
+    REJECT = 2        // New element is discarded
+};
+
+// How a consumer thread idles when its queue is empty
+enum class WaitStrategy : uint8_t {
+    BUSY_POLL = 0,        // Spin forever, lowest latency, burns a core
+    SPIN_THEN_YIELD = 1,  // Spin, then yield the CPU between polls
+    SPIN_THEN_PARK = 2    // Spin, then sleep until a producer wakes us
+};
+
+// Market data structures. Prices are in ticks and sizes in lots of the
+// instrument (fixed_point.h).
 struct Tick {
     InstrumentId instrument_id;
     Price bid_price;
     Quantity bid_size;
     Price ask_price;
     Quantity ask_size;
-    Timestamp timestamp;
+    Timestamp exchange_timestamp;   // Event time reported by the exchange, 0 if unknown
+    Timestamp receive_timestamp;    // Time the tick entered this process
 };
 
+static_assert(sizeof(Tick) == 40, "Tick layout changed");
+
 struct Order {
     OrderId order_id;
     InstrumentId instrument_id;
@@ -71,10 +92,14 @@ struct Order {
     Quantity filled_quantity;
     OrderState state;
     Market market;
+    StrategyId strategy_id{0};  // Originating strategy, 0 if entered by other means
     Timestamp timestamp;
 };
 
-// Risk limits structure
+static_assert(sizeof(Order) == 48, "Order layout changed");
+
+// Risk limits structure. Limits span instruments, so they are in currency
+// and shares rather than ticks and lots.
 struct RiskLimits {
     double max_position_size;
     double max_daily_loss;
@@ -16,6 +16,72 @@ struct SystemConfig {
     size_t queue_capacity = 100000;
     int64_t max_latency_microseconds = 10;
     
+    // How often the TSC clock re-syncs with CLOCK_REALTIME, 0 or less never
+    int64_t clock_recalibration_interval_ms = 1000;
+    
+    // Market data queue settings
+    OverflowPolicy tick_queue_overflow_policy = OverflowPolicy::BLOCK;
+    WaitStrategy market_data_wait_strategy = WaitStrategy::SPIN_THEN_PARK;
+    uint32_t spin_iterations = 10000;
+    
+    // Run thread_pool_size market data workers, partitioned by instrument
+    bool market_data_sharded = false;
+    
+    // Batched tick delivery: max ticks per batch and how long a worker may
+    // hold a partial batch waiting for more ticks (0 = dispatch immediately)
+    size_t tick_batch_size = 64;
+    int64_t tick_batch_latency_us = 0;
+    
+    // Worker threads running strategies in parallel, 0 runs them serially on
+    // the market data thread
+    size_t strategy_threads = 0;
+    
+    // Cross-sectional factor panel: EWMA smoothing factors and how often to
+    // recompute (0 = after every batch)
+    double factor_fast_alpha = 0.2;
+    double factor_slow_alpha = 0.02;
+    double factor_variance_alpha = 0.05;
+    int64_t factor_recompute_interval_us = 0;
+    
+    // Keep only the latest tick per instrument when consumers fall behind
+    bool market_data_conflation = false;
+    
+    // Contract terms of instruments without an InstrumentSpec
+    double default_tick_size = 0.01;
+    double default_lot_size = 1.0;
+    
+    // Defaults for order books created by binary feeds. Each book is
+    // allocated up front at 16 bytes per price level (both sides) and 40
+    // bytes per order (pool entry plus hash slots), so these take about
+    // 64 KB + 640 KB per instrument: a window of +/-2048 ticks around the
+    // first price and up to 16k resting orders. Raise them per instrument
+    // with MarketDataFeed::addInstrument for deeper books.
+    size_t feed_book_price_levels = 1 << 12;
+    size_t feed_book_max_orders = 1 << 14;
+    
+    // Tick capture journal segment size in bytes
+    size_t tick_journal_segment_size = 256 * 1024 * 1024;
+    
+    // Order store: slots for live orders, and how many retired orders stay
+    // queryable (both rounded up to powers of two)
+    size_t oms_slab_capacity = 1 << 16;
+    size_t oms_archive_capacity = 1 << 18;
+    
+    // Order write-ahead journal, off when the path prefix is empty. Events
+    // are group-committed to disk at most the sync interval apart.
+    std::string order_journal_path = "";
+    size_t order_journal_segment_size = 64 * 1024 * 1024;
+    size_t order_journal_queue_capacity = 1 << 16;
+    int64_t order_journal_sync_interval_us = 1000;
+    
+    // Execution management: capacity of the outgoing order and incoming
+    // execution queues, and how their workers idle when the queues are empty
+    size_t execution_queue_capacity = 1 << 16;
+    WaitStrategy execution_wait_strategy = WaitStrategy::SPIN_THEN_PARK;
+    
+    // Instrument ids are dense indices below this bound
+    size_t max_instruments = 1 << 24;
+    
     // Market settings
     std::unordered_map<Market, std::string> market_configs = {
         {Market::CHINA_SSE, "sse_config.json"},
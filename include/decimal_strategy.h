@@ -0,0 +1,123 @@
+#ifndef DECIMAL_STRATEGY_H
+#define DECIMAL_STRATEGY_H
+
+#include <vector>
+#include "common_types.h"
+#include "instrument_spec.h"
+#include "strategy_engine.h"
+
+// Compatibility layer for strategies written against floating-point prices
+// and quantities. DecimalTick and DecimalOrder carry the fields as decimal
+// values in currency and shares; a strategy derived from DecimalStrategy
+// keeps its old logic on them and runs in the StrategyEngine next to
+// ported strategies, with every event converted through InstrumentSpecs on
+// the way in and every signal on the way out. Signal prices and quantities
+// round to the instrument's tick and lot.
+//
+// To port a strategy, derive it from Strategy instead and work in ticks and
+// lots; InstrumentSpecs converts individual values where a strategy still
+// needs decimals, so the move can be made a piece at a time.
+
+struct DecimalTick {
+    InstrumentId instrument_id;
+    double bid_price;
+    double bid_size;
+    double ask_price;
+    double ask_size;
+    Timestamp exchange_timestamp;
+    Timestamp receive_timestamp;
+};
+
+struct DecimalOrder {
+    OrderId order_id;
+    InstrumentId instrument_id;
+    OrderType type;
+    OrderSide side;
+    double price;
+    double quantity;
+    double filled_quantity;
+    OrderState state;
+    Market market;
+    StrategyId strategy_id;
+    Timestamp timestamp;
+};
+
+inline DecimalTick toDecimal(const Tick& tick) {
+    InstrumentSpec spec = InstrumentSpecs::getInstance().getSpec(tick.instrument_id);
+    DecimalTick decimal;
+    decimal.instrument_id = tick.instrument_id;
+    decimal.bid_price = spec.toDecimal(tick.bid_price);
+    decimal.bid_size = spec.toDecimal(tick.bid_size);
+    decimal.ask_price = spec.toDecimal(tick.ask_price);
+    decimal.ask_size = spec.toDecimal(tick.ask_size);
+    decimal.exchange_timestamp = tick.exchange_timestamp;
+    decimal.receive_timestamp = tick.receive_timestamp;
+    return decimal;
+}
+
+inline Tick fromDecimal(const DecimalTick& decimal) {
+    InstrumentSpec spec = InstrumentSpecs::getInstance().getSpec(decimal.instrument_id);
+    Tick tick;
+    tick.instrument_id = decimal.instrument_id;
+    tick.bid_price = spec.toPrice(decimal.bid_price);
+    tick.bid_size = spec.toQuantity(decimal.bid_size);
+    tick.ask_price = spec.toPrice(decimal.ask_price);
+    tick.ask_size = spec.toQuantity(decimal.ask_size);
+    tick.exchange_timestamp = decimal.exchange_timestamp;
+    tick.receive_timestamp = decimal.receive_timestamp;
+    return tick;
+}
+
+inline DecimalOrder toDecimal(const Order& order) {
+    InstrumentSpec spec = InstrumentSpecs::getInstance().getSpec(order.instrument_id);
+    DecimalOrder decimal;
+    decimal.order_id = order.order_id;
+    decimal.instrument_id = order.instrument_id;
+    decimal.type = order.type;
+    decimal.side = order.side;
+    decimal.price = spec.toDecimal(order.price);
+    decimal.quantity = spec.toDecimal(order.quantity);
+    decimal.filled_quantity = spec.toDecimal(order.filled_quantity);
+    decimal.state = order.state;
+    decimal.market = order.market;
+    decimal.strategy_id = order.strategy_id;
+    decimal.timestamp = order.timestamp;
+    return decimal;
+}
+
+inline Order fromDecimal(const DecimalOrder& decimal) {
+    InstrumentSpec spec = InstrumentSpecs::getInstance().getSpec(decimal.instrument_id);
+    Order order;
+    order.order_id = decimal.order_id;
+    order.instrument_id = decimal.instrument_id;
+    order.type = decimal.type;
+    order.side = decimal.side;
+    order.price = spec.toPrice(decimal.price);
+    order.quantity = spec.toQuantity(decimal.quantity);
+    order.filled_quantity = spec.toQuantity(decimal.filled_quantity);
+    order.state = decimal.state;
+    order.market = decimal.market;
+    order.strategy_id = decimal.strategy_id;
+    order.timestamp = decimal.timestamp;
+    return order;
+}
+
+// Strategy on decimal prices. Implement the decimal hooks in place of
+// onTick(), onOrderUpdate() and generateSignals().
+class DecimalStrategy : public Strategy {
+public:
+    virtual void onDecimalTick(const DecimalTick& tick) = 0;
+    virtual void onDecimalOrderUpdate(const DecimalOrder& order) = 0;
+    virtual std::vector<DecimalOrder> generateDecimalSignals() { return {}; }
+
+    void onTick(const Tick& tick) final { onDecimalTick(toDecimal(tick)); }
+    void onOrderUpdate(const Order& order) final { onDecimalOrderUpdate(toDecimal(order)); }
+
+    void emitSignals(SignalSink& sink) final {
+        for (const auto& signal : generateDecimalSignals()) {
+            sink.emit(fromDecimal(signal));
+        }
+    }
+};
+
+#endif // DECIMAL_STRATEGY_H
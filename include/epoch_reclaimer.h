@@ -0,0 +1,137 @@
+#ifndef EPOCH_RECLAIMER_H
+#define EPOCH_RECLAIMER_H
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <cstdint>
+#include "common_types.h"
+
+// Read-copy-update support: readers bracket their access to published
+// pointers with a Guard, writers unpublish objects and retire() them, and a
+// retired object is destroyed only once every reader that could still see
+// it has left. Readers never block and never wait for writers; entering and
+// leaving costs one atomic increment and decrement on a counter that is
+// usually private to the thread.
+//
+// Readers count themselves into one of two halves selected by the parity of
+// a global epoch. The epoch may only advance once the half it is about to
+// reuse has drained, so anything retired at epoch e is unreachable by the
+// time the epoch reaches e + 2. Readers hash onto a fixed set of padded
+// slots; threads sharing a slot remain correct because slots are counters.
+//
+// retire() and reclaim() must be serialized by the caller (writers normally
+// hold their own update mutex). reclaim() never blocks.
+class EpochReclaimer {
+public:
+    class Guard {
+    public:
+        explicit Guard(EpochReclaimer& reclaimer) : counter_(reclaimer.enter()) {}
+        ~Guard() { counter_->fetch_sub(1, std::memory_order_release); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        std::atomic<int64_t>* counter_;
+    };
+
+    EpochReclaimer() {
+        for (auto& slot : slots_) {
+            slot.readers[0].store(0, std::memory_order_relaxed);
+            slot.readers[1].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Destroys everything still retired; no reader may be active
+    ~EpochReclaimer() {
+        for (auto& retired : retired_) {
+            retired.destroy();
+        }
+    }
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    // Schedule destruction of an object that is no longer published
+    void retire(std::function<void()> destroy) {
+        retired_.push_back({epoch_.load(std::memory_order_relaxed), std::move(destroy)});
+    }
+
+    template <typename T>
+    void retireObject(const T* object) {
+        if (object) {
+            retire([object] { delete object; });
+        }
+    }
+
+    // Advance the epoch as far as readers allow and destroy what is safe.
+    // Returns the number of objects still waiting.
+    size_t reclaim() {
+        for (int step = 0; step < 2 && tryAdvance(); ++step) {
+        }
+
+        uint64_t epoch = epoch_.load(std::memory_order_acquire);
+        size_t kept = 0;
+        for (size_t i = 0; i < retired_.size(); ++i) {
+            if (retired_[i].epoch + 2 <= epoch) {
+                retired_[i].destroy();
+            } else {
+                retired_[kept++] = std::move(retired_[i]);
+            }
+        }
+        retired_.resize(kept);
+        return kept;
+    }
+
+    size_t getRetiredCount() const { return retired_.size(); }
+
+private:
+    static constexpr size_t SLOT_COUNT = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<int64_t> readers[2];
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        std::function<void()> destroy;
+    };
+
+    std::atomic<int64_t>* enter() {
+        static thread_local const size_t slot_index = std::hash<std::thread::id>()(std::this_thread::get_id()) % SLOT_COUNT;
+        Slot& slot = slots_[slot_index];
+
+        for (;;) {
+            uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+            std::atomic<int64_t>& counter = slot.readers[epoch & 1];
+            counter.fetch_add(1, std::memory_order_seq_cst);
+            // If the epoch moved meanwhile we may have joined a half that is
+            // being drained; step out and join the current one instead
+            if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+                return &counter;
+            }
+            counter.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // Move to the next epoch if no reader remains in the half it will reuse
+    bool tryAdvance() {
+        uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        size_t reuse = (epoch + 1) & 1;
+        for (auto& slot : slots_) {
+            if (slot.readers[reuse].load(std::memory_order_seq_cst) != 0) {
+                return false;
+            }
+        }
+        epoch_.store(epoch + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    Slot slots_[SLOT_COUNT];
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> epoch_{0};
+    std::vector<Retired> retired_;
+};
+
+#endif // EPOCH_RECLAIMER_H
@@ -3,14 +3,18 @@
 
 #include <memory>
 #include <functional>
-#include <queue>
-#include <mutex>
 #include <thread>
 #include <atomic>
-#include <condition_variable>
 #include "common_types.h"
 #include "config.h"
-
+#include "ring_buffer.h"
+#include "wait_strategy.h"
+
+// Order and execution traffic to and from the markets. Outgoing orders and
+// incoming execution reports each go through a lock-free ring to a worker
+// thread, which any number of threads can feed; the workers idle according to
+// the configured wait strategy and run the execution callback without holding
+// any lock.
 class ExecutionManagementSystem {
 public:
     using ExecutionCallback = std::function<void(const Order&)>;
@@ -21,9 +25,14 @@ public:
     // Initialize the EMS
     bool initialize(ExecutionCallback callback);
 
-    // Send order to market
+    // Queue an order for the send thread, false if the EMS is not running
+    // or the outgoing queue is full
     bool sendOrderToMarket(const Order& order);
 
+    // Queue an execution report received from a market for the receive
+    // thread, false if the EMS is not running or the incoming queue is full
+    bool receiveExecution(const Order& execution);
+
     // Cancel order at market
     bool sendCancelToMarket(OrderId order_id);
 
@@ -36,6 +45,8 @@ public:
     // Get statistics
     uint64_t getOrdersSent() const { return orders_sent_; }
     uint64_t getOrdersAcked() const { return orders_acked_; }
+    uint64_t getOrdersRejected() const { return orders_rejected_; }
+    uint64_t getExecutionsReceived() const { return executions_received_; }
 
     // Start and stop methods
     void start();
@@ -48,22 +59,25 @@ private:
     // Worker thread for receiving executions
     void receiveWorker();
 
-    // Queue for outgoing orders
-    struct OutgoingOrderQueue {
-        std::queue<Order> queue_;
-        std::mutex mutex_;
-        std::atomic<bool> stopped_{false};
-    };
+    // Order queue drained by one worker
+    struct WorkQueue {
+        WorkQueue(size_t capacity, WaitStrategy strategy, uint32_t spin_iterations)
+            : ring_(capacity), waiter_(strategy, spin_iterations) {}
 
-    // Queue for incoming executions
-    struct IncomingExecutionQueue {
-        std::queue<Order> queue_;
-        std::mutex mutex_;
+        BoundedRingBuffer<Order> ring_;
+        ConsumerWaiter waiter_;
         std::atomic<bool> stopped_{false};
     };
 
-    std::unique_ptr<OutgoingOrderQueue> outgoing_queue_;
-    std::unique_ptr<IncomingExecutionQueue> incoming_queue_;
+    // Push onto a worker's queue and wake it
+    static bool enqueue(WorkQueue& queue, const Order& order);
+
+    // Take the next order off a worker's queue, idling while it is empty;
+    // false once the EMS stops
+    bool dequeue(WorkQueue& queue, Order& order);
+
+    std::unique_ptr<WorkQueue> outgoing_queue_;
+    std::unique_ptr<WorkQueue> incoming_queue_;
 
     std::unique_ptr<std::thread> send_thread_;
     std::unique_ptr<std::thread> receive_thread_;
@@ -71,6 +85,8 @@ private:
     std::atomic<bool> running_{false};
     std::atomic<uint64_t> orders_sent_{0};
     std::atomic<uint64_t> orders_acked_{0};
+    std::atomic<uint64_t> orders_rejected_{0};
+    std::atomic<uint64_t> executions_received_{0};
 
     // Callback for execution updates
     ExecutionCallback execution_callback_;
@@ -79,4 +95,4 @@ private:
     std::unordered_map<Market, std::string> market_endpoints_;
 };
 
-#endif // EXECUTION_MANAGEMENT_SYSTEM_H
\ No newline at end of file
+#endif // EXECUTION_MANAGEMENT_SYSTEM_H
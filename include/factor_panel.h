@@ -0,0 +1,105 @@
+#ifndef FACTOR_PANEL_H
+#define FACTOR_PANEL_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include "common_types.h"
+#include "config.h"
+#include "instrument_table.h"
+
+// Factor values and composite score of one instrument
+struct FactorScore {
+    InstrumentId instrument_id;
+    double score;          // Weighted sum of cross-sectional factor z-scores
+    double last_return;    // Mid return since the previous recompute
+    double momentum;       // Fast EMA over slow EMA of the mid, minus one
+    double volatility;     // EWMA standard deviation of returns
+    double spread_bps;     // Quoted spread in basis points of the mid
+};
+
+// Universe ranked by score, best first. Instruments without a two-sided
+// quote yet are left out.
+struct FactorSnapshot {
+    uint64_t sequence;
+    Timestamp timestamp;
+    std::vector<FactorScore> ranked;
+};
+
+// Weights applied to each factor's cross-sectional z-score
+struct FactorWeights {
+    double last_return = 0.0;
+    double momentum = 1.0;
+    double volatility = -0.5;
+    double spread = -0.25;
+};
+
+// Cross-sectional factor engine over a fixed universe. The latest quotes
+// are kept as a struct of arrays (one contiguous, cache-aligned column per
+// field) so a recompute is a handful of straight vector passes over the
+// whole universe: AVX-512 or AVX2 when the build targets them, scalar
+// otherwise. Each recompute publishes an immutable ranked snapshot that
+// strategies on any thread can pick up without locking.
+//
+// Ticks must be fed from a single thread (or under the caller's lock); the
+// recompute runs on that thread, either every batch or once
+// factor_recompute_interval_us has elapsed.
+class FactorPanel {
+public:
+    explicit FactorPanel(const std::vector<InstrumentId>& universe);
+    ~FactorPanel();
+
+    FactorPanel(const FactorPanel&) = delete;
+    FactorPanel& operator=(const FactorPanel&) = delete;
+
+    // Record the latest quote of an instrument, ignored outside the universe
+    void update(const Tick& tick);
+
+    // Record a batch and recompute if due; matches TickBatchCallback
+    void processTicks(const Tick* ticks, size_t count);
+
+    // Recompute all factors and publish a new snapshot now
+    void recompute();
+
+    // Latest published snapshot, never null
+    std::shared_ptr<const FactorSnapshot> getSnapshot() const {
+        return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+    }
+
+    void setWeights(const FactorWeights& weights) { weights_ = weights; }
+    const FactorWeights& getWeights() const { return weights_; }
+
+    size_t getUniverseSize() const { return universe_.size(); }
+    uint64_t getRecomputeCount() const { return recompute_count_; }
+
+    // Instruction set the factor kernels were built for
+    static const char* getKernelName();
+
+private:
+    // Column storage, padded to a whole number of 512-bit vectors
+    struct Columns;
+
+    struct RankEntry {
+        uint64_t key;      // Score mapped to an unsigned key, smallest is best
+        uint32_t column;
+    };
+
+    void publish();
+
+    std::vector<InstrumentId> universe_;
+    InstrumentTable<uint32_t> column_of_;   // Instrument -> column + 1, 0 if not in the universe
+    std::unique_ptr<Columns> columns_;
+
+    SystemConfig config_;
+    FactorWeights weights_;
+    Timestamp last_recompute_{0};
+    bool dirty_{false};
+
+    std::vector<RankEntry> rank_order_;
+    std::vector<RankEntry> rank_scratch_;
+    std::shared_ptr<const FactorSnapshot> snapshot_;
+    std::atomic<uint64_t> recompute_count_{0};
+};
+
+#endif // FACTOR_PANEL_H
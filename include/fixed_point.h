@@ -0,0 +1,66 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstdint>
+
+// Integer count of an instrument-specific unit. Prices count ticks and
+// quantities count lots of their instrument, so the arithmetic that the
+// pipeline does on them (comparisons, spreads, level offsets, fill sums) is
+// exact and independent of evaluation order. 32 bits cover any realistic
+// price in ticks or order size in lots; sums that can grow beyond that, such
+// as positions and notionals, are widened to 64 bits by the code that forms
+// them. What a count means in currency or shares is given by the
+// instrument's InstrumentSpec (instrument_spec.h), which is applied only at
+// the edges: decoding feeds, entering orders and reporting.
+//
+// The Unit tag keeps prices and quantities from mixing, and there is no
+// implicit conversion from floating point, so a decimal value can never be
+// stored as a count by accident.
+template <typename Unit>
+class FixedPoint {
+public:
+    using Rep = int32_t;
+
+    // Uninitialized like a built-in; FixedPoint{} is zero
+    FixedPoint() = default;
+    constexpr explicit FixedPoint(Rep count) : count_(count) {}
+
+    constexpr Rep count() const { return count_; }
+
+    constexpr FixedPoint operator+(FixedPoint other) const { return FixedPoint(count_ + other.count_); }
+    constexpr FixedPoint operator-(FixedPoint other) const { return FixedPoint(count_ - other.count_); }
+    constexpr FixedPoint operator-() const { return FixedPoint(-count_); }
+    FixedPoint& operator+=(FixedPoint other) { count_ += other.count_; return *this; }
+    FixedPoint& operator-=(FixedPoint other) { count_ -= other.count_; return *this; }
+
+    constexpr bool operator==(FixedPoint other) const { return count_ == other.count_; }
+    constexpr bool operator!=(FixedPoint other) const { return count_ != other.count_; }
+    constexpr bool operator<(FixedPoint other) const { return count_ < other.count_; }
+    constexpr bool operator<=(FixedPoint other) const { return count_ <= other.count_; }
+    constexpr bool operator>(FixedPoint other) const { return count_ > other.count_; }
+    constexpr bool operator>=(FixedPoint other) const { return count_ >= other.count_; }
+
+private:
+    Rep count_;
+};
+
+struct PriceUnit {};
+struct QuantityUnit {};
+
+// Price in ticks of its instrument
+using Price = FixedPoint<PriceUnit>;
+
+// Quantity in lots of its instrument
+using Quantity = FixedPoint<QuantityUnit>;
+
+// Exact value of a quantity at a price, in tick-lots
+inline int64_t notional(Price price, Quantity quantity) {
+    return static_cast<int64_t>(price.count()) * quantity.count();
+}
+
+// Mid of two prices in ticks, which may fall halfway between two ticks
+inline double midPrice(Price bid, Price ask) {
+    return (static_cast<double>(bid.count()) + ask.count()) / 2.0;
+}
+
+#endif // FIXED_POINT_H
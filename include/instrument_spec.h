@@ -0,0 +1,99 @@
+#ifndef INSTRUMENT_SPEC_H
+#define INSTRUMENT_SPEC_H
+
+#include <cmath>
+#include <cstdint>
+#include "common_types.h"
+#include "config.h"
+#include "seqlock.h"
+#include "instrument_table.h"
+
+// Contract terms that give an instrument's integer prices and quantities
+// their decimal meaning. Decimal values round to the nearest tick or lot and
+// saturate at the range of a count.
+struct InstrumentSpec {
+    double tick_size;   // Price increment
+    double lot_size;    // Quantity increment, in shares or contracts
+
+    Price toPrice(double price) const { return Price(toCount(price / tick_size)); }
+    Quantity toQuantity(double quantity) const { return Quantity(toCount(quantity / lot_size)); }
+
+    double toDecimal(Price price) const { return price.count() * tick_size; }
+    double toDecimal(Quantity quantity) const { return quantity.count() * lot_size; }
+
+    // Currency value of a notional in tick-lots
+    double toValue(int64_t tick_lots) const { return static_cast<double>(tick_lots) * tick_size * lot_size; }
+
+    static int32_t toCount(double units) {
+        double rounded = std::round(units);
+        if (rounded >= 2147483647.0) {
+            return INT32_MAX;
+        }
+        if (rounded <= -2147483648.0) {
+            return INT32_MIN;
+        }
+        return rounded == rounded ? static_cast<int32_t>(rounded) : 0;
+    }
+};
+
+// Process-wide instrument specs, read from any thread without locking.
+// Instruments without a spec use the default_tick_size and default_lot_size
+// config. A spec should be set before the instrument's first price is
+// converted: changing it later reinterprets every price already held as
+// ticks.
+class InstrumentSpecs {
+public:
+    InstrumentSpecs(size_t max_instruments, const InstrumentSpec& default_spec)
+        : specs_(max_instruments), default_spec_(default_spec) {}
+
+    InstrumentSpecs(const InstrumentSpecs&) = delete;
+    InstrumentSpecs& operator=(const InstrumentSpecs&) = delete;
+
+    static InstrumentSpecs& getInstance() {
+        static InstrumentSpecs instance(ConfigManager::getInstance().max_instruments,
+                                        {ConfigManager::getInstance().default_tick_size,
+                                         ConfigManager::getInstance().default_lot_size});
+        return instance;
+    }
+
+    // Set the terms of an instrument, false for ids beyond max_instruments
+    // or sizes that are not positive
+    bool setSpec(InstrumentId instrument_id, const InstrumentSpec& spec) {
+        if (!(spec.tick_size > 0) || !(spec.lot_size > 0)) {
+            return false;
+        }
+        Slot* slot = specs_.getOrCreate(instrument_id);
+        if (!slot) {
+            return false;
+        }
+        slot->spec.store(spec);
+        return true;
+    }
+
+    InstrumentSpec getSpec(InstrumentId instrument_id) const {
+        const Slot* slot = specs_.find(instrument_id);
+        if (!slot || slot->spec.version() == 0) {
+            return default_spec_;
+        }
+        return slot->spec.load();
+    }
+
+    Price toPrice(InstrumentId instrument_id, double price) const { return getSpec(instrument_id).toPrice(price); }
+    Quantity toQuantity(InstrumentId instrument_id, double quantity) const {
+        return getSpec(instrument_id).toQuantity(quantity);
+    }
+    double toDecimal(InstrumentId instrument_id, Price price) const { return getSpec(instrument_id).toDecimal(price); }
+    double toDecimal(InstrumentId instrument_id, Quantity quantity) const {
+        return getSpec(instrument_id).toDecimal(quantity);
+    }
+
+private:
+    struct Slot {
+        Seqlock<InstrumentSpec> spec;
+    };
+
+    InstrumentTable<Slot> specs_;
+    InstrumentSpec default_spec_;
+};
+
+#endif // INSTRUMENT_SPEC_H
@@ -0,0 +1,90 @@
+#ifndef INSTRUMENT_TABLE_H
+#define INSTRUMENT_TABLE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include "common_types.h"
+
+// Per-instrument storage indexed directly by instrument id. Entries are
+// allocated in fixed-size segments the first time an id in the segment is
+// touched and stay at a stable address until the table is destroyed, so
+// readers on any thread can hold entry pointers without locking.
+template <typename T, size_t SEGMENT_SIZE = 1024>
+class InstrumentTable {
+public:
+    explicit InstrumentTable(size_t max_instruments)
+        : max_instruments_(max_instruments),
+          segment_count_((max_instruments + SEGMENT_SIZE - 1) / SEGMENT_SIZE),
+          segments_(new std::atomic<Segment*>[segment_count_]) {
+        for (size_t i = 0; i < segment_count_; ++i) {
+            segments_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~InstrumentTable() {
+        for (size_t i = 0; i < segment_count_; ++i) {
+            delete segments_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    InstrumentTable(const InstrumentTable&) = delete;
+    InstrumentTable& operator=(const InstrumentTable&) = delete;
+
+    // Entry for an instrument, nullptr if it was never created
+    T* find(InstrumentId instrument_id) const {
+        if (instrument_id >= max_instruments_) {
+            return nullptr;
+        }
+        Segment* segment = segments_[instrument_id / SEGMENT_SIZE].load(std::memory_order_acquire);
+        return segment ? &segment->entries[instrument_id % SEGMENT_SIZE] : nullptr;
+    }
+
+    // Entry for an instrument, allocating its segment if needed.
+    // Returns nullptr for ids beyond max_instruments.
+    T* getOrCreate(InstrumentId instrument_id) {
+        if (instrument_id >= max_instruments_) {
+            return nullptr;
+        }
+
+        std::atomic<Segment*>& slot = segments_[instrument_id / SEGMENT_SIZE];
+        Segment* segment = slot.load(std::memory_order_acquire);
+        if (!segment) {
+            // Race to install a new segment, losers free theirs
+            Segment* fresh = new Segment();
+            if (slot.compare_exchange_strong(segment, fresh, std::memory_order_acq_rel)) {
+                segment = fresh;
+            } else {
+                delete fresh;
+            }
+        }
+        return &segment->entries[instrument_id % SEGMENT_SIZE];
+    }
+
+    // Visit every allocated entry as fn(instrument_id, entry)
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t s = 0; s < segment_count_; ++s) {
+            Segment* segment = segments_[s].load(std::memory_order_acquire);
+            if (!segment) {
+                continue;
+            }
+            for (size_t i = 0; i < SEGMENT_SIZE; ++i) {
+                fn(static_cast<InstrumentId>(s * SEGMENT_SIZE + i), segment->entries[i]);
+            }
+        }
+    }
+
+    size_t maxInstruments() const { return max_instruments_; }
+
+private:
+    struct Segment {
+        T entries[SEGMENT_SIZE];
+    };
+
+    const size_t max_instruments_;
+    const size_t segment_count_;
+    std::unique_ptr<std::atomic<Segment*>[]> segments_;
+};
+
+#endif // INSTRUMENT_TABLE_H
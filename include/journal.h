@@ -0,0 +1,115 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Header at the start of every journal segment file
+struct JournalSegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;   // Records published so far
+    uint64_t reserved[5];
+};
+
+static_assert(sizeof(JournalSegmentHeader) == 64, "Journal header must stay one cache line");
+
+// Append-only writer of fixed-size binary records into pre-allocated,
+// memory-mapped segment files named <prefix>.<index>.journal. A new segment
+// is created when the current one is full. Not thread-safe: a journal has a
+// single writer thread.
+class JournalWriter {
+public:
+    JournalWriter(const std::string& path_prefix, uint32_t record_size, size_t segment_size);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Open the next unused segment after any that already exist
+    bool open();
+
+    // Copy one record into the journal, rolling segments as needed
+    bool append(const void* record);
+
+    // Make appended records visible to readers of the live segment through
+    // its header. The kernel may write the header back before the records,
+    // so journals that must survive a crash leave this to sync().
+    void publish();
+
+    // Flush appended records to stable storage, then publish them and flush
+    // the header. Only pages written since the previous sync are flushed.
+    bool sync();
+
+    // Sync, trim the current segment to its used size and unmap it
+    void close();
+
+    bool isOpen() const { return base_ != nullptr; }
+    uint64_t getRecordsWritten() const { return records_written_; }
+    size_t getSegmentsCreated() const { return segments_created_; }
+
+private:
+    bool openSegment(size_t index);
+    void closeSegment();
+
+    std::string path_prefix_;
+    uint32_t record_size_;
+    size_t segment_size_;
+    size_t records_per_segment_;
+
+    int fd_{-1};
+    char* base_{nullptr};
+    size_t segment_index_{0};
+    uint64_t segment_records_{0};
+    size_t synced_bytes_{0};        // Prefix of the segment known to be on disk
+    uint64_t records_written_{0};
+    size_t segments_created_{0};
+};
+
+// Zero-copy reader over all segments of a journal. Records are served
+// straight from the read-only mappings.
+class JournalReader {
+public:
+    JournalReader(const std::string& path_prefix, uint32_t record_size);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // Map every existing segment, returns false if none could be read.
+    // Reading stops at the first segment written in another format or
+    // version.
+    bool open();
+    void close();
+
+    // Whether open() stopped at a segment in another format or version
+    bool isIncompatible() const { return incompatible_; }
+
+    size_t getSegmentCount() const { return segments_.size(); }
+    uint64_t getRecordCount() const { return total_records_; }
+
+    // First record of a segment and the number of records it holds
+    const void* segmentRecords(size_t segment) const;
+    uint64_t segmentRecordCount(size_t segment) const;
+
+private:
+    struct MappedSegment {
+        char* base;
+        size_t length;
+        uint64_t record_count;
+    };
+
+    std::string path_prefix_;
+    uint32_t record_size_;
+    std::vector<MappedSegment> segments_;
+    uint64_t total_records_{0};
+    bool incompatible_{false};
+};
+
+// File name of one journal segment
+std::string journalSegmentPath(const std::string& path_prefix, size_t index);
+
+#endif // JOURNAL_H
@@ -0,0 +1,67 @@
+#ifndef LAST_VALUE_CACHE_H
+#define LAST_VALUE_CACHE_H
+
+#include "common_types.h"
+#include "config.h"
+#include "seqlock.h"
+#include "instrument_table.h"
+
+// Process-wide cache of the latest Tick per instrument. MarketDataHandler
+// writes it; risk, OMS and strategies read it from any thread. Each slot is
+// a seqlock on its own cache line, so readers never take a lock, never write
+// shared memory and only retry if they overlap a write to the same slot.
+// Backtests create private instances so they never see live quotes.
+class LastValueCache {
+public:
+    explicit LastValueCache(size_t max_instruments) : slots_(max_instruments) {}
+
+    LastValueCache(const LastValueCache&) = delete;
+    LastValueCache& operator=(const LastValueCache&) = delete;
+
+    static LastValueCache& getInstance() {
+        static LastValueCache instance(ConfigManager::getInstance().max_instruments);
+        return instance;
+    }
+
+    // Publish the latest tick of an instrument
+    void update(const Tick& tick) {
+        Slot* slot = slots_.getOrCreate(tick.instrument_id);
+        if (slot) {
+            slot->tick.store(tick);
+        }
+    }
+
+    // Latest tick of an instrument, false if none has been published
+    bool get(InstrumentId instrument_id, Tick& tick) const {
+        const Slot* slot = slots_.find(instrument_id);
+        if (!slot || slot->tick.version() == 0) {
+            return false;
+        }
+        tick = slot->tick.load();
+        return true;
+    }
+
+    // Mid price of the latest quote in ticks, 0 if unknown
+    double getMidPrice(InstrumentId instrument_id) const {
+        Tick tick;
+        if (!get(instrument_id, tick) || tick.bid_price.count() <= 0 || tick.ask_price.count() <= 0) {
+            return 0.0;
+        }
+        return midPrice(tick.bid_price, tick.ask_price);
+    }
+
+    // Number of updates published for an instrument
+    uint64_t getUpdateCount(InstrumentId instrument_id) const {
+        const Slot* slot = slots_.find(instrument_id);
+        return slot ? slot->tick.version() : 0;
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        Seqlock<Tick> tick;
+    };
+
+    InstrumentTable<Slot> slots_;
+};
+
+#endif // LAST_VALUE_CACHE_H
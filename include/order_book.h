@@ -0,0 +1,126 @@
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "common_types.h"
+
+// Aggregated quantity resting at one price
+struct BookLevel {
+    Quantity quantity;
+    uint32_t order_count;
+};
+
+// Price level used when reporting depth
+struct DepthLevel {
+    Price price;
+    Quantity quantity;
+    uint32_t order_count;
+};
+
+// Order book for one instrument, maintained from incremental add/modify/
+// delete events. Prices are in ticks, so price levels live in two contiguous
+// arrays indexed by the offset from base_price over a fixed window, and individual orders
+// (L3) live in a pre-allocated pool located through an open-addressing hash,
+// so every event is O(1) apart from re-finding the best price after the top
+// level empties. Aggregated (L2) feeds can set levels directly instead.
+// Not thread-safe: a book is owned by the thread decoding its feed.
+class OrderBook {
+public:
+    using TickCallback = std::function<void(const Tick&)>;
+
+    OrderBook(InstrumentId instrument_id, Price base_price, size_t price_levels, size_t max_orders);
+
+    // Called with a derived top-of-book Tick whenever best bid/ask changes
+    void setTickCallback(TickCallback callback) { tick_callback_ = callback; }
+
+    // Timestamps stamped on derived Ticks for the events that follow
+    void setEventTimestamps(Timestamp exchange_timestamp, Timestamp receive_timestamp) {
+        exchange_timestamp_ = exchange_timestamp;
+        receive_timestamp_ = receive_timestamp;
+    }
+
+    // L3 events, keyed by the exchange's order reference
+    bool addOrder(uint64_t order_ref, OrderSide side, Price price, Quantity quantity);
+    bool modifyOrder(uint64_t order_ref, Price new_price, Quantity new_quantity);
+    bool reduceOrder(uint64_t order_ref, Quantity quantity);
+    bool replaceOrder(uint64_t order_ref, uint64_t new_order_ref, Price new_price, Quantity new_quantity);
+    bool deleteOrder(uint64_t order_ref);
+
+    // L2 event: replace the aggregated quantity at a price
+    bool setLevel(OrderSide side, Price price, Quantity quantity);
+
+    // Drop all orders and levels
+    void clear();
+
+    // Top of book
+    bool hasBid() const { return best_bid_ >= 0; }
+    bool hasAsk() const { return best_ask_ < static_cast<int64_t>(levels_); }
+    Price getBestBid() const { return hasBid() ? priceAt(best_bid_) : Price(0); }
+    Price getBestAsk() const { return hasAsk() ? priceAt(best_ask_) : Price(0); }
+    Tick toTick() const;
+
+    // Copy up to max_levels levels from the top of one side, returns the count
+    size_t getDepth(OrderSide side, DepthLevel* out, size_t max_levels) const;
+
+    InstrumentId getInstrumentId() const { return instrument_id_; }
+    size_t getOrderCount() const { return order_count_; }
+    uint64_t getUpdatesApplied() const { return updates_applied_; }
+    uint64_t getUpdatesRejected() const { return updates_rejected_; }
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    struct OrderEntry {
+        uint64_t order_ref;
+        int64_t level;
+        Quantity quantity;
+        OrderSide side;
+        uint32_t next_free;
+    };
+
+    // Price <-> level index conversion, -1 when outside the window
+    int64_t levelOf(Price price) const;
+    Price priceAt(int64_t level) const { return Price(static_cast<Price::Rep>(base_price_.count() + level)); }
+
+    // Add (or remove, with negative quantity) resting quantity at a level
+    void adjustLevel(OrderSide side, int64_t level, Quantity quantity, int32_t orders);
+
+    // L3 hash operations
+    uint32_t findSlot(uint64_t order_ref) const;
+    bool insertOrder(uint64_t order_ref, uint32_t entry);
+    void eraseSlot(uint32_t slot);
+    uint32_t allocateEntry();
+    void releaseEntry(uint32_t entry);
+
+    // Emit a derived Tick if the top of book moved
+    void publishIfTopChanged();
+
+    InstrumentId instrument_id_;
+    Price base_price_;
+    size_t levels_;
+
+    std::vector<BookLevel> bids_;
+    std::vector<BookLevel> asks_;
+    int64_t best_bid_;
+    int64_t best_ask_;
+
+    std::vector<OrderEntry> orders_;
+    std::vector<uint32_t> hash_;   // Slot -> order entry, EMPTY when unused
+    uint64_t hash_mask_;
+    uint32_t free_head_;
+    size_t order_count_{0};
+
+    // Last published top of book
+    Tick last_top_{};
+    Timestamp exchange_timestamp_{0};
+    Timestamp receive_timestamp_{0};
+
+    uint64_t updates_applied_{0};
+    uint64_t updates_rejected_{0};
+
+    TickCallback tick_callback_;
+};
+
+#endif // ORDER_BOOK_H
@@ -0,0 +1,170 @@
+#ifndef ORDER_JOURNAL_H
+#define ORDER_JOURNAL_H
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include "common_types.h"
+#include "journal.h"
+#include "ring_buffer.h"
+#include "wait_strategy.h"
+
+// What happened to an order
+enum class OrderEventType : uint8_t {
+    SUBMIT = 0,
+    CANCEL = 1,    // Cancel requested
+    MODIFY = 2,
+    STATE = 3      // State change reported by the venue
+};
+
+// One journaled order event: the event and the order as it stood right
+// after it. Replaying images in journal order rebuilds the order store; a
+// record's position in the journal is its sequence number.
+struct OrderJournalRecord {
+    OrderId order_id;
+    InstrumentId instrument_id;
+    Timestamp timestamp;
+    Price price;
+    Quantity quantity;
+    Quantity filled_quantity;
+    StrategyId strategy_id;
+    OrderEventType event;
+    OrderType type;
+    OrderSide side;
+    OrderState state;
+    Market market;
+    uint8_t reserved[19];
+};
+
+static_assert(sizeof(OrderJournalRecord) == 64, "Order journal records must stay one cache line");
+
+// Write-ahead journal of order events. record() copies the event into a
+// bounded ring and returns; a dedicated writer thread appends records to
+// the mapped segments and group-commits them to stable storage, syncing at
+// most sync_interval apart however many events arrived in between. A crash
+// can lose events younger than the last sync; flush() waits until
+// everything recorded so far is durable.
+class OrderJournalWriter {
+public:
+    OrderJournalWriter(const std::string& path_prefix, size_t segment_size, size_t queue_capacity,
+                       std::chrono::microseconds sync_interval);
+    ~OrderJournalWriter();
+
+    OrderJournalWriter(const OrderJournalWriter&) = delete;
+    OrderJournalWriter& operator=(const OrderJournalWriter&) = delete;
+
+    // Open the journal after any existing segments and start the writer thread
+    bool start();
+
+    // Drain and sync pending events, stop the writer thread and close the journal
+    void stop();
+
+    // Hot path: queue an event. A write-ahead log cannot drop, so a full
+    // ring makes the caller wait for the writer.
+    void record(OrderEventType event, const Order& order) {
+        OrderJournalRecord entry;
+        entry.order_id = order.order_id;
+        entry.instrument_id = order.instrument_id;
+        entry.price = order.price;
+        entry.quantity = order.quantity;
+        entry.filled_quantity = order.filled_quantity;
+        entry.timestamp = order.timestamp;
+        entry.strategy_id = order.strategy_id;
+        entry.event = event;
+        entry.type = order.type;
+        entry.side = order.side;
+        entry.state = order.state;
+        entry.market = order.market;
+        std::memset(entry.reserved, 0, sizeof(entry.reserved));
+
+        if (!ring_.tryPush(entry)) {
+            queue_full_.fetch_add(1, std::memory_order_relaxed);
+            do {
+                waiter_.notify();
+                std::this_thread::yield();
+            } while (!ring_.tryPush(entry));
+        }
+        waiter_.notify();
+    }
+
+    // Block until every event recorded before the call is on stable storage.
+    // False once an event has failed to reach the journal, and from then on.
+    bool flush();
+
+    // Whether an event was lost or a sync failed
+    bool hasFailed() const { return failed_.load(std::memory_order_acquire); }
+
+    // Get statistics
+    uint64_t getRecordsWritten() const { return records_written_; }
+    uint64_t getSyncCount() const { return sync_count_; }
+    uint64_t getQueueFullCount() const { return queue_full_; }
+
+private:
+    void writerThread();
+    size_t drain();
+    void sync();
+
+    // Mark the journal as incomplete, logging the first failure
+    void fail(const std::string& reason);
+
+    JournalWriter journal_;
+    BoundedRingBuffer<OrderJournalRecord> ring_;
+    ConsumerWaiter waiter_;
+    const std::chrono::microseconds sync_interval_;
+    std::unique_ptr<std::thread> writer_thread_;
+    std::atomic<bool> running_{false};
+
+    // Writer thread state
+    uint64_t unsynced_{0};
+    std::chrono::steady_clock::time_point last_sync_;
+
+    // flush() takes a ticket; the writer acknowledges tickets once synced
+    std::atomic<uint64_t> flush_requests_{0};
+    std::atomic<uint64_t> flushed_{0};
+
+    // Sticky: tickets are not acknowledged after an event was lost
+    std::atomic<bool> failed_{false};
+
+    std::atomic<uint64_t> records_written_{0};
+    std::atomic<uint64_t> sync_count_{0};
+    std::atomic<uint64_t> queue_full_{0};
+};
+
+// Zero-copy view of an order journal
+class OrderJournalReader {
+public:
+    explicit OrderJournalReader(const std::string& path_prefix);
+
+    bool open() { return journal_.open(); }
+    void close() { journal_.close(); }
+
+    // Whether a segment was written in another format or version
+    bool isIncompatible() const { return journal_.isIncompatible(); }
+
+    uint64_t getRecordCount() const { return journal_.getRecordCount(); }
+
+    // Visit every record in journal order; stop early if fn returns false
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t segment = 0; segment < journal_.getSegmentCount(); ++segment) {
+            uint64_t count = journal_.segmentRecordCount(segment);
+            const auto* records = static_cast<const OrderJournalRecord*>(journal_.segmentRecords(segment));
+            for (uint64_t i = 0; i < count; ++i) {
+                if (!fn(records[i])) {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    JournalReader journal_;
+};
+
+// Order image carried by a record
+Order orderFromJournalRecord(const OrderJournalRecord& record);
+
+#endif // ORDER_JOURNAL_H
@@ -2,61 +2,111 @@
 #define ORDER_MANAGEMENT_SYSTEM_H
 
 #include <memory>
-#include <unordered_map>
-#include <mutex>
 #include <queue>
 #include <functional>
 #include <atomic>
+#include <vector>
 #include "common_types.h"
 #include "config.h"
-
+#include "order_store.h"
+#include "order_journal.h"
+
+// Order lifecycle management. Every operation is thread-safe and takes no
+// lock: each order changes state with a compare-and-swap on its slot in the
+// OrderStore, and the order callback runs afterwards on the calling thread,
+// holding nothing, with a copy of the order as it was left. Updates of one
+// order from several threads therefore reach the callback in no particular
+// order; the timestamp tells them apart.
+//
+// Live orders can be selected in bulk by instrument, market, side and
+// originating strategy through the store's secondary indexes, which is what
+// cancelAll() uses to flatten a book without scanning every order.
 class OrderManagementSystem {
 public:
     using OrderCallback = std::function<void(const Order&)>;
+    using OrderBatchCallback = std::function<void(const Order* orders, size_t count)>;
 
     OrderManagementSystem();
     ~OrderManagementSystem();
 
-    // Initialize the OMS
+    // Initialize the OMS. With SystemConfig::order_journal_path set, order
+    // state is first rebuilt from the journal and every change from then on
+    // is journaled.
     bool initialize(OrderCallback callback);
 
+    // Deliver the updates of bulk operations in one call rather than one
+    // order callback each. Set before orders flow.
+    void setBatchCallback(OrderBatchCallback callback) { batch_callback_ = std::move(callback); }
+
     // Submit a new order
     OrderId submitOrder(const Order& order);
 
     // Cancel an existing order
     bool cancelOrder(OrderId order_id);
 
+    // Request cancellation of every live order matching the filter and
+    // emit the cancels as one batch. Orders already pending cancel are
+    // skipped. Returns the number of cancels issued.
+    size_t cancelAll(const OrderFilter& filter);
+
     // Modify an existing order
     bool modifyOrder(OrderId order_id, const Order& new_order);
 
+    // Apply a state change reported by the venue, false if the order is not
+    // live or the transition is not valid; terminal orders are retired from
+    // the live store
+    bool updateOrderState(OrderId order_id, OrderState new_state);
+
     // Get order status
     OrderState getOrderStatus(OrderId order_id) const;
 
-    // Get order by ID
+    // Get order by ID, live or recently retired
     Order getOrder(OrderId order_id) const;
 
+    // Orders not yet in a terminal state
+    size_t getLiveOrderCount() const;
+
+    // Ids of the live orders matching the filter
+    std::vector<OrderId> getLiveOrders(const OrderFilter& filter) const;
+
+    // Wait until every order event so far is on stable storage, false if
+    // journaling is off
+    bool flushJournal();
+
     // Get statistics
     uint64_t getOrdersSubmitted() const { return orders_submitted_; }
     uint64_t getOrdersFilled() const { return orders_filled_; }
+    uint64_t getEventsRecovered() const { return events_recovered_; }
 
 private:
+    // Rebuild the order store from a journal, returns false if it is unreadable
+    bool recoverFromJournal(const std::string& path_prefix);
+
+    // Journal an event, a no-op when journaling is off
+    void journal(OrderEventType event, const Order& order) {
+        if (journal_) {
+            journal_->record(event, order);
+        }
+    }
+
     // Validate order before submission
     bool validateOrder(const Order& order);
 
-    // Update order state
-    void updateOrderState(OrderId order_id, OrderState new_state);
+    // Lock-free order storage; the store also assigns order ids
+    std::unique_ptr<OrderStore> orders_;
 
-    // Thread-safe order storage
-    mutable std::mutex orders_mutex_;
-    std::unordered_map<OrderId, Order> orders_;
+    // Write-ahead journal, events are recorded while their order is held so
+    // each order's events are journaled in the order they happened
+    std::unique_ptr<OrderJournalWriter> journal_;
+    uint64_t events_recovered_{0};
 
     // Atomic counters
-    std::atomic<OrderId> next_order_id_{1};
     std::atomic<uint64_t> orders_submitted_{0};
     std::atomic<uint64_t> orders_filled_{0};
 
-    // Callback for order updates
+    // Callbacks for order updates
     OrderCallback order_callback_;
+    OrderBatchCallback batch_callback_;
 
     // System configuration
     SystemConfig config_;
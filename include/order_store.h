@@ -0,0 +1,328 @@
+#ifndef ORDER_STORE_H
+#define ORDER_STORE_H
+
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include "common_types.h"
+#include "instrument_table.h"
+#include "seqlock.h"
+#include "wait_strategy.h"
+
+// Whether an order can no longer change
+inline bool isTerminalState(OrderState state) {
+    return state == OrderState::FILLED || state == OrderState::CANCELLED ||
+           state == OrderState::REJECTED || state == OrderState::EXPIRED;
+}
+
+// Order lifecycle: whether an order may move from one state to another.
+// A state moving to itself is a repeat report or an amendment of a live
+// order; terminal states never change.
+bool isValidTransition(OrderState from, OrderState to);
+
+// Selects live orders by any combination of instrument, market, side and
+// originating strategy; criteria left unset match every order
+struct OrderFilter {
+    bool by_instrument{false};
+    bool by_market{false};
+    bool by_side{false};
+    bool by_strategy{false};
+    InstrumentId instrument_id{0};
+    Market market{Market::UNKNOWN};
+    OrderSide side{OrderSide::BUY};
+    StrategyId strategy_id{0};
+
+    static OrderFilter all() { return OrderFilter(); }
+
+    static OrderFilter instrument(InstrumentId instrument_id) {
+        OrderFilter filter;
+        filter.by_instrument = true;
+        filter.instrument_id = instrument_id;
+        return filter;
+    }
+
+    static OrderFilter forMarket(Market market) {
+        OrderFilter filter;
+        filter.by_market = true;
+        filter.market = market;
+        return filter;
+    }
+
+    static OrderFilter forSide(OrderSide side) {
+        OrderFilter filter;
+        filter.by_side = true;
+        filter.side = side;
+        return filter;
+    }
+
+    static OrderFilter strategy(StrategyId strategy_id) {
+        OrderFilter filter;
+        filter.by_strategy = true;
+        filter.strategy_id = strategy_id;
+        return filter;
+    }
+
+    bool matches(const Order& order) const {
+        return (!by_instrument || order.instrument_id == instrument_id) &&
+               (!by_market || order.market == market) &&
+               (!by_side || order.side == side) &&
+               (!by_strategy || order.strategy_id == strategy_id);
+    }
+};
+
+// Dense storage for the orders of one OMS. Live orders sit in a
+// pre-allocated slab addressed by their id modulo its capacity, so a lookup
+// is one indexed load and a tag compare. The store assigns ids: they
+// increase monotonically and skip any id whose slot is still held by an
+// older live order, so the slab only fills up when every slot is live.
+// Orders that reach a terminal state are retired into a fixed-size archive
+// of compact records, addressed the same way, which keeps the most recent
+// history queryable while memory stays flat however many orders a session
+// sees.
+//
+// Live orders are also threaded onto intrusive lists by instrument, market,
+// side and originating strategy, so finding every order of, say, one
+// strategy walks just those orders. An order joins its lists when created
+// and leaves them when retired, while its slot is held; each list has a
+// small spin lock covering its head and its members' links. Lists with few
+// keys (market, side) are sharded by slot so concurrent creators rarely
+// meet on one lock.
+//
+// Order state is thread-safe without locks. Each slot has a state word
+// holding a sequence number and the order state. A writer claims a slot by
+// moving the sequence from even to odd with a compare-and-swap, after
+// checking the transition against isValidTransition, so racing updates of
+// one order are ordered and illegal ones fail without touching it; updates
+// of different orders never contend. Readers copy the slot optimistically
+// and retry if a write overlapped, as with Seqlock.
+class OrderStore {
+public:
+    // Capacities are rounded up to powers of two; the archive is at least
+    // as large as the slab. Orders for instruments at or beyond
+    // max_instruments are stored but not indexed by instrument.
+    OrderStore(size_t slab_capacity, size_t archive_capacity, size_t max_instruments);
+    ~OrderStore();
+
+    OrderStore(const OrderStore&) = delete;
+    OrderStore& operator=(const OrderStore&) = delete;
+
+    // Store a new order under the next free id, then run init(Order&) on
+    // the stored copy before anyone else can see or change it. On success
+    // `stored` is the order as stored, id included. Returns 0 if every slot
+    // holds a live order.
+    template <typename Init>
+    OrderId create(const Order& order, Init&& init, Order& stored) {
+        uint64_t word;
+        Slot* slot = claim(word);
+        if (!slot) {
+            return 0;
+        }
+
+        OrderId order_id = slot->order_id.load(std::memory_order_relaxed);
+        slot->order = order;
+        slot->order.order_id = order_id;
+        init(slot->order);
+        slot->order.state = order.state;
+        stored = slot->order;
+        link(*slot);
+
+        uint64_t sequence = (word & ~STATE_MASK) + 2 * SEQUENCE_ONE;
+        slot->word.store(sequence | static_cast<uint64_t>(order.state), std::memory_order_release);
+        return order_id;
+    }
+
+    // Put an order back exactly as recorded, live or terminal, and keep new
+    // ids above it. For recovery, before the store is shared between threads.
+    // Fails for a live order whose slot already holds a different live
+    // order, which happens when the slab is smaller than when the orders
+    // were recorded.
+    bool restore(const Order& order);
+
+    // Move a live order to `new_state`, applying mutate(Order&) to its other
+    // fields in the same step; mutate sees the new state and must not change
+    // it or the indexed fields. Mutations of one order run one at a time in
+    // transition order. Fails if the order is not live or the transition is
+    // not valid. On success `updated` is the order as stored; a terminal
+    // order has already been retired.
+    template <typename Mutate>
+    bool transition(OrderId order_id, OrderState new_state, Mutate&& mutate, Order& updated) {
+        return apply(order_id, [new_state](OrderState) { return new_state; }, mutate, updated);
+    }
+
+    // Change the fields of a live order without changing its state, allowed
+    // wherever the state may repeat itself
+    template <typename Mutate>
+    bool amend(OrderId order_id, Mutate&& mutate, Order& updated) {
+        return apply(order_id, [](OrderState current) { return current; }, mutate, updated);
+    }
+
+    // Live or archived order, false once the archive has overwritten it
+    bool get(OrderId order_id, Order& order) const;
+
+    // Append the ids of live orders matching the filter, walking the most
+    // selective index the filter names; returns how many were appended.
+    // Orders created or retired during the call may or may not be seen.
+    size_t findLive(const OrderFilter& filter, std::vector<OrderId>& order_ids) const;
+
+    // Orders in the slab; scans it, so meant for monitoring rather than
+    // the order path
+    size_t getLiveCount() const;
+    size_t getSlabCapacity() const { return slab_mask_ + 1; }
+    size_t getArchiveCapacity() const { return archive_mask_ + 1; }
+    uint64_t getIdsSkipped() const { return ids_skipped_.load(std::memory_order_relaxed); }
+
+private:
+    // State word: sequence << 8 | state. An odd sequence means a writer
+    // holds the slot.
+    static constexpr uint64_t STATE_MASK = 0xff;
+    static constexpr uint64_t SEQUENCE_ONE = uint64_t(1) << 8;
+
+    static bool isBusy(uint64_t word) { return (word & SEQUENCE_ONE) != 0; }
+    static OrderState stateOf(uint64_t word) { return static_cast<OrderState>(word & STATE_MASK); }
+
+    // Secondary indexes over live orders
+    enum Index : size_t { BY_INSTRUMENT = 0, BY_MARKET, BY_SIDE, BY_STRATEGY, INDEX_COUNT };
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+    static constexpr size_t MARKET_COUNT = static_cast<size_t>(Market::USA_NASDAQ) + 1;
+    static constexpr size_t SIDE_COUNT = 2;
+    static constexpr size_t INDEX_SHARDS = 8;
+    static constexpr size_t MAX_INDEXED_STRATEGIES = 1 << 16;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> word{0};
+        std::atomic<OrderId> order_id{0};   // 0 when free
+        Order order{};
+        // Neighbours on each index list, guarded by that list's lock
+        uint32_t next[INDEX_COUNT];
+        uint32_t prev[INDEX_COUNT];
+    };
+
+    // Head of an intrusive list of slots
+    struct IndexList {
+        std::atomic<bool> locked{false};
+        uint32_t head{NO_SLOT};
+
+        void lock() {
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                while (locked.load(std::memory_order_relaxed)) {
+                    cpuRelax();
+                }
+            }
+        }
+        void unlock() { locked.store(false, std::memory_order_release); }
+    };
+
+    // Shard of a low-cardinality index, on its own cache line
+    struct alignas(CACHE_LINE_SIZE) ShardList : IndexList {};
+
+    // Terminal order with the fields packed tightly
+    struct ArchivedOrder {
+        OrderId order_id;
+        InstrumentId instrument_id;
+        Timestamp timestamp;
+        Price price;
+        Quantity quantity;
+        Quantity filled_quantity;
+        StrategyId strategy_id;
+        OrderType type;
+        OrderSide side;
+        OrderState state;
+        Market market;
+    };
+
+    // Claim a live order's slot for a write whose target state is
+    // target(current). Returns the word to restore on release, or 0 if the
+    // order is not live or the transition is invalid.
+    template <typename Target>
+    uint64_t acquire(Slot& slot, OrderId order_id, Target&& target, OrderState& new_state) {
+        uint64_t word = slot.word.load(std::memory_order_acquire);
+        for (;;) {
+            if (isBusy(word)) {
+                cpuRelax();
+                word = slot.word.load(std::memory_order_acquire);
+                continue;
+            }
+            // The id only changes under the busy bit, so it is stable here
+            // unless the CAS below fails
+            if (slot.order_id.load(std::memory_order_relaxed) != order_id) {
+                return 0;
+            }
+            new_state = target(stateOf(word));
+            if (!isValidTransition(stateOf(word), new_state)) {
+                return 0;
+            }
+            if (slot.word.compare_exchange_weak(word, word + SEQUENCE_ONE, std::memory_order_acquire)) {
+                std::atomic_thread_fence(std::memory_order_release);
+                return word;
+            }
+        }
+    }
+
+    template <typename Target, typename Mutate>
+    bool apply(OrderId order_id, Target&& target, Mutate& mutate, Order& updated) {
+        if (order_id == 0) {
+            return false;
+        }
+        Slot& slot = slab_[order_id & slab_mask_];
+        OrderState new_state;
+        uint64_t word = acquire(slot, order_id, target, new_state);
+        if (word == 0) {
+            return false;
+        }
+
+        slot.order.state = new_state;
+        mutate(slot.order);
+        updated = slot.order;
+        if (isTerminalState(new_state)) {
+            unlink(slot);
+            retire(slot);
+        }
+
+        uint64_t sequence = (word & ~STATE_MASK) + 2 * SEQUENCE_ONE;
+        slot.word.store(sequence | static_cast<uint64_t>(new_state), std::memory_order_release);
+        return true;
+    }
+
+    // Take the slot of the next free id and hold it; the id is written into
+    // the slot. Returns nullptr after a full lap of live slots.
+    Slot* claim(uint64_t& word);
+
+    // Archive a terminal order and free its slot, the slot must be held
+    void retire(Slot& slot);
+
+    // Write the archive record of a terminal order
+    void archive(const Order& order);
+
+    // The list of an index that holds a slot's order, nullptr if the
+    // order's key lies beyond the index. Keys out of the enum's range are
+    // filed under the first value so every live order is on a market list.
+    IndexList* listFor(Index index, const Slot& slot, bool create) const;
+
+    // Add a held slot's order to, or remove it from, its index lists
+    void link(Slot& slot);
+    void unlink(Slot& slot);
+
+    // Append matching ids found on one list
+    size_t collect(IndexList& list, Index index, const OrderFilter& filter, std::vector<OrderId>& order_ids) const;
+
+    uint32_t slotIndex(const Slot& slot) const { return static_cast<uint32_t>(&slot - slab_.get()); }
+
+    std::unique_ptr<Slot[]> slab_;
+    std::unique_ptr<Seqlock<ArchivedOrder>[]> archive_;
+    size_t slab_mask_;
+    size_t archive_mask_;
+
+    // Index heads; the lists are guarded by their own locks, so lookups
+    // through a const store still take them
+    mutable InstrumentTable<IndexList> by_instrument_;
+    mutable InstrumentTable<IndexList> by_strategy_;
+    mutable ShardList by_market_[MARKET_COUNT][INDEX_SHARDS];
+    mutable ShardList by_side_[SIDE_COUNT][INDEX_SHARDS];
+
+    alignas(CACHE_LINE_SIZE) std::atomic<OrderId> next_id_{1};
+    std::atomic<uint64_t> ids_skipped_{0};
+};
+
+#endif // ORDER_STORE_H
@@ -0,0 +1,61 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include "common_types.h"
+#include "backtest_engine.h"
+
+class TickJournalReader;
+
+// One parameter set: a label for the results table and a function that
+// registers its strategies on a fresh BacktestEngine
+struct SweepCase {
+    std::string label;
+    std::function<void(BacktestEngine&)> setup;
+};
+
+struct SweepResult {
+    std::string label;
+    BacktestStats stats;
+};
+
+// Runs many backtests over the same history in parallel. Ticks are decoded
+// once and shared read-only by every run (a journal is used in place from
+// its mapping); each run owns a separate BacktestEngine, so positions, P&L,
+// risk state and quotes never mix. Runs are spread over a work-stealing
+// pool, one run per task, and results come back in case order.
+class ParameterSweep {
+public:
+    ParameterSweep(const Tick* ticks, size_t count, const BacktestConfig& config = BacktestConfig());
+    ParameterSweep(const TickJournalReader& journal, const BacktestConfig& config = BacktestConfig());
+
+    void addCase(SweepCase sweep_case) { cases_.push_back(std::move(sweep_case)); }
+
+    // Grid of SimpleMeanReversionStrategy parameters, one strategy per instrument
+    void addMeanReversionGrid(const std::vector<InstrumentId>& instruments,
+                              const std::vector<double>& thresholds,
+                              const std::vector<size_t>& window_sizes);
+
+    // Run every case on thread_count threads (0 = all cores)
+    std::vector<SweepResult> run(size_t thread_count = 0);
+
+    size_t getCaseCount() const { return cases_.size(); }
+
+    // Print results as an aligned table, best total P&L first
+    static void printTable(std::ostream& out, std::vector<SweepResult> results);
+
+private:
+    struct TickSpan {
+        const Tick* ticks;
+        size_t count;
+    };
+
+    std::vector<TickSpan> spans_;
+    BacktestConfig config_;
+    std::vector<SweepCase> cases_;
+};
+
+#endif // PARAMETER_SWEEP_H
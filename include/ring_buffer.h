@@ -0,0 +1,110 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+#include "common_types.h"
+
+// Bounded lock-free ring buffer (Vyukov-style sequenced slots).
+// Safe for any number of producers and consumers; the common case in this
+// system is many producers feeding one worker thread. Capacity is rounded up
+// to a power of two and all storage is allocated once at construction.
+template <typename T>
+class BoundedRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "Ring elements must be trivially copyable");
+
+public:
+    explicit BoundedRingBuffer(size_t capacity)
+        : capacity_(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          cells_(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedRingBuffer(const BoundedRingBuffer&) = delete;
+    BoundedRingBuffer& operator=(const BoundedRingBuffer&) = delete;
+
+    // Push an element, returns false if the ring is full
+    bool tryPush(const T& value) {
+        size_t pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pop an element, returns false if the ring is empty
+    bool tryPop(T& value) {
+        size_t pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.data;
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Empty
+            } else {
+                pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate number of queued elements
+    size_t size() const {
+        size_t head = dequeue_pos_.value.load(std::memory_order_acquire);
+        size_t tail = enqueue_pos_.value.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    struct alignas(CACHE_LINE_SIZE) Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) PaddedIndex {
+        std::atomic<size_t> value{0};
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Producer and consumer indices live on separate cache lines
+    PaddedIndex enqueue_pos_;
+    PaddedIndex dequeue_pos_;
+};
+
+#endif // RING_BUFFER_H
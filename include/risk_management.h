@@ -7,16 +7,55 @@
 #include <atomic>
 #include <chrono>
 #include <thread>
+#include <cstdlib>
+#include <algorithm>
 #include "common_types.h"
 #include "config.h"
+#include "instrument_spec.h"
 
+class LastValueCache;
+
+// Net holding of one instrument, kept in exact integers: lots, and
+// tick-lots for cost and realized P&L (InstrumentSpec::toValue turns them
+// into currency). Unrealized P&L is marked at a mid that may fall between
+// two ticks, so it alone is fractional.
 struct Position {
     InstrumentId instrument_id;
-    double quantity;
-    double average_price;
+    int64_t quantity;           // Lots, negative when short
+    int64_t cost;               // Entry cost of the open lots, signed like quantity
+    int64_t realized_pnl;
     double unrealized_pnl;
-    double realized_pnl;
-    std::chrono::time_point<std::chrono::system_clock> last_update;
+    Timestamp last_update;
+
+    // Average entry price in ticks, 0 when flat
+    double averagePrice() const { return quantity ? static_cast<double>(cost) / quantity : 0.0; }
+
+    // Apply a fill of `lots` (negative for sells) at `price`. Reducing
+    // releases the closed lots' share of the entry cost, rounded toward
+    // zero; a flip opens the remainder at the fill price and closing out
+    // clears the unrealized P&L. Returns the realized P&L of the fill.
+    int64_t applyFill(int64_t lots, Price price) {
+        if (quantity == 0 || (quantity > 0) == (lots > 0)) {
+            quantity += lots;
+            cost += lots * price.count();
+            return 0;
+        }
+
+        int64_t closed = std::min(std::llabs(lots), std::llabs(quantity));
+        int64_t closed_lots = quantity > 0 ? closed : -closed;
+        int64_t closed_cost = static_cast<int64_t>(static_cast<__int128>(cost) * closed / std::llabs(quantity));
+        int64_t realized = closed_lots * price.count() - closed_cost;
+
+        realized_pnl += realized;
+        cost -= closed_cost;
+        quantity += lots;
+        if (quantity == 0) {
+            unrealized_pnl = 0.0; // Flat, nothing left to mark
+        } else if ((quantity > 0) != (closed_lots > 0)) {
+            cost = quantity * price.count(); // Flipped, the remainder opened here
+        }
+        return realized;
+    }
 };
 
 class RiskManagement {
@@ -36,19 +75,39 @@ public:
     // Check if position is within limits
     bool checkPosition(const Position& position);
 
-    // Get current position for instrument
+    // Get current position for instrument, marked to the latest quote
     Position getPosition(InstrumentId instrument_id) const;
 
+    // Mark every position to the latest quotes in the last-value cache
+    void markToMarket();
+
     // Get total portfolio value
     double getTotalValue() const;
 
     // Reset daily statistics
     void resetDailyStats();
 
+    // Quotes used for marking and market order checks, the process-wide
+    // cache unless replaced (e.g. by a backtest)
+    void setQuoteSource(const LastValueCache* quotes);
+
+    // Print a line for every rejected order (on by default with enable_logging)
+    void setLogRejections(bool enabled) { log_rejections_ = enabled; }
+
+    uint64_t getOrdersRejected() const { return orders_rejected_; }
+
 private:
+    // Unrealized P&L of a position at the latest mid price
+    void markPosition(Position& position) const;
+
     // Calculate value at risk
     double calculateVaR(InstrumentId instrument_id, double quantity);
 
+    // Position in shares, for the limits
+    double positionSize(InstrumentId instrument_id, int64_t lots) const {
+        return specs_.getSpec(instrument_id).lot_size * static_cast<double>(lots);
+    }
+
     // Check various risk limits
     bool checkPositionSize(const Order& order);
     bool checkDailyLoss();
@@ -66,11 +125,16 @@ private:
     double peak_portfolio_value_{0.0};
     double current_drawdown_{0.0};
     int orders_last_second_{0};
-    std::chrono::time_point<std::chrono::steady_clock> last_second_check_;
+    Timestamp last_second_check_;
 
     // Risk limits
     RiskLimits risk_limits_;
 
+    const LastValueCache* quotes_;
+    const InstrumentSpecs& specs_;
+    bool log_rejections_;
+    std::atomic<uint64_t> orders_rejected_{0};
+
     // Atomic flags
     std::atomic<bool> initialized_{false};
     std::atomic<double> total_portfolio_value_{0.0};
@@ -0,0 +1,324 @@
+#ifndef ROLLING_STATISTICS_H
+#define ROLLING_STATISTICS_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "fixed_point.h"
+
+// Rolling indicators over a fixed number of samples. Every indicator
+// allocates its storage once at construction and updates in O(1) per sample,
+// so the cost of a push does not depend on the window length. Not
+// thread-safe: an indicator belongs to the strategy that feeds it.
+
+// Fixed-capacity ring of the most recent samples
+template <typename T>
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t capacity)
+        : buffer_(capacity > 0 ? capacity : 1) {}
+
+    // Append a sample. When the window is full the oldest sample is
+    // overwritten and copied to evicted; returns whether that happened.
+    bool push(const T& value, T& evicted) {
+        bool full = count_ == buffer_.size();
+        if (full) {
+            evicted = buffer_[head_];
+        } else {
+            ++count_;
+        }
+        buffer_[head_] = value;
+        head_ = (head_ + 1 == buffer_.size()) ? 0 : head_ + 1;
+        return full;
+    }
+
+    // i = 0 is the oldest sample, size() - 1 the newest
+    const T& operator[](size_t i) const {
+        size_t index = head_ + buffer_.size() - count_ + i;
+        return buffer_[index >= buffer_.size() ? index - buffer_.size() : index];
+    }
+
+    const T& newest() const { return (*this)[count_ - 1]; }
+    const T& oldest() const { return (*this)[0]; }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return buffer_.size(); }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == buffer_.size(); }
+
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+    }
+
+private:
+    std::vector<T> buffer_;
+    size_t head_{0};   // Next slot to write
+    size_t count_{0};
+};
+
+// Running sum of a window's samples. Integer samples, such as prices in
+// ticks and sizes in lots, are summed exactly in 64 bits. Floating-point
+// samples use Neumaier's compensated summation, which carries the low-order
+// bits each addition loses, so adding samples and subtracting evicted ones
+// does not drift however long the window runs.
+template <typename T>
+class RunningSum {
+public:
+    void add(T value) { sum_ += value; }
+    double value() const { return static_cast<double>(sum_); }
+    void clear() { sum_ = 0; }
+
+private:
+    int64_t sum_{0};
+};
+
+template <>
+class RunningSum<double> {
+public:
+    void add(double value) {
+        double sum = sum_ + value;
+        if (std::fabs(sum_) >= std::fabs(value)) {
+            compensation_ += (sum_ - sum) + value;
+        } else {
+            compensation_ += (value - sum) + sum_;
+        }
+        sum_ = sum;
+    }
+    double value() const { return sum_ + compensation_; }
+    void clear() {
+        sum_ = 0.0;
+        compensation_ = 0.0;
+    }
+
+private:
+    double sum_{0.0};
+    double compensation_{0.0};
+};
+
+// Simple moving average of integer or floating-point samples
+template <typename T>
+class BasicRollingMean {
+public:
+    explicit BasicRollingMean(size_t window) : window_(window) {}
+
+    void push(T value) {
+        T evicted{};
+        if (window_.push(value, evicted)) {
+            sum_.add(-evicted);
+        }
+        sum_.add(value);
+    }
+
+    double mean() const { return window_.empty() ? 0.0 : sum_.value() / window_.size(); }
+    double sum() const { return sum_.value(); }
+    T last() const { return window_.empty() ? T{} : window_.newest(); }
+    size_t size() const { return window_.size(); }
+    bool ready() const { return window_.full(); }
+
+    void clear() {
+        window_.clear();
+        sum_.clear();
+    }
+
+private:
+    RollingWindow<T> window_;
+    RunningSum<T> sum_;
+};
+
+using RollingMean = BasicRollingMean<double>;
+
+// Exponential moving average, alpha = 2 / (period + 1) unless given directly.
+// Needs no window; seeded with the first sample.
+class ExponentialMovingAverage {
+public:
+    explicit ExponentialMovingAverage(size_t period)
+        : alpha_(2.0 / (static_cast<double>(period) + 1.0)) {}
+
+    static ExponentialMovingAverage withAlpha(double alpha) {
+        ExponentialMovingAverage ema(1);
+        ema.alpha_ = alpha;
+        return ema;
+    }
+
+    void push(double value) {
+        if (count_++ == 0) {
+            value_ = value;
+        } else {
+            value_ += alpha_ * (value - value_);
+        }
+    }
+
+    double value() const { return value_; }
+    double alpha() const { return alpha_; }
+    uint64_t count() const { return count_; }
+
+    void clear() {
+        value_ = 0.0;
+        count_ = 0;
+    }
+
+private:
+    double alpha_;
+    double value_{0.0};
+    uint64_t count_{0};
+};
+
+// Rolling mean and variance using Welford's update, extended to replace the
+// evicted sample once the window is full. Stable where sum / sum-of-squares
+// would cancel catastrophically for prices far from zero.
+class RollingVariance {
+public:
+    explicit RollingVariance(size_t window) : window_(window) {}
+
+    void push(double value) {
+        double evicted = 0.0;
+        if (window_.push(value, evicted)) {
+            double n = static_cast<double>(window_.size());
+            double old_mean = mean_;
+            mean_ += (value - evicted) / n;
+            m2_ += (value - evicted) * (value - mean_ + evicted - old_mean);
+            if (m2_ < 0.0) {
+                m2_ = 0.0; // Rounding on a near-constant window
+            }
+        } else {
+            double n = static_cast<double>(window_.size());
+            double delta = value - mean_;
+            mean_ += delta / n;
+            m2_ += delta * (value - mean_);
+        }
+    }
+
+    double mean() const { return mean_; }
+    double last() const { return window_.empty() ? 0.0 : window_.newest(); }
+
+    // Sample variance (n - 1 denominator)
+    double variance() const {
+        return window_.size() > 1 ? m2_ / static_cast<double>(window_.size() - 1) : 0.0;
+    }
+    double stddev() const { return std::sqrt(variance()); }
+
+    // Standard score of a value against the window, 0 when the window is flat
+    double zScore(double value) const {
+        double sd = stddev();
+        return sd > 0.0 ? (value - mean_) / sd : 0.0;
+    }
+    double zScore() const { return zScore(last()); }
+
+    size_t size() const { return window_.size(); }
+    bool ready() const { return window_.full(); }
+
+    void clear() {
+        window_.clear();
+        mean_ = 0.0;
+        m2_ = 0.0;
+    }
+
+private:
+    RollingWindow<double> window_;
+    double mean_{0.0};
+    double m2_{0.0};
+};
+
+// Rolling minimum or maximum using a monotonic deque kept in a fixed ring.
+// Each sample enters and leaves the deque at most once, so pushes are
+// amortised O(1). Compare(a, b) is true when a should dominate b.
+template <typename Compare>
+class RollingExtremum {
+public:
+    explicit RollingExtremum(size_t window)
+        : window_(window > 0 ? window : 1), entries_(window_) {}
+
+    void push(double value) {
+        // Drop the front if this sample pushes it out of the window
+        if (size_ > 0 && sequence_ - entries_[head_].sequence >= window_) {
+            head_ = (head_ + 1 == window_) ? 0 : head_ + 1;
+            --size_;
+        }
+
+        // Drop samples that can never become the extremum again
+        while (size_ > 0 && !Compare()(entries_[back()].value, value)) {
+            --size_;
+        }
+        entries_[(head_ + size_) % window_] = {sequence_, value};
+        ++size_;
+        ++sequence_;
+    }
+
+    double value() const { return size_ > 0 ? entries_[head_].value : 0.0; }
+    bool empty() const { return size_ == 0; }
+    bool ready() const { return sequence_ >= window_; }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+        sequence_ = 0;
+    }
+
+private:
+    struct Entry {
+        uint64_t sequence;
+        double value;
+    };
+
+    size_t back() const { return (head_ + size_ - 1) % window_; }
+
+    size_t window_;
+    std::vector<Entry> entries_;
+    size_t head_{0};
+    size_t size_{0};
+    uint64_t sequence_{0};
+};
+
+struct RollingMinCompare {
+    bool operator()(double kept, double incoming) const { return kept < incoming; }
+};
+struct RollingMaxCompare {
+    bool operator()(double kept, double incoming) const { return kept > incoming; }
+};
+
+using RollingMin = RollingExtremum<RollingMinCompare>;
+using RollingMax = RollingExtremum<RollingMaxCompare>;
+
+// Volume-weighted average price over the last N trades or quotes. Prices in
+// ticks and volumes in lots keep the notional and volume sums exact.
+class RollingVwap {
+public:
+    explicit RollingVwap(size_t window) : window_(window) {}
+
+    void push(Price price, Quantity volume) {
+        Sample sample{notional(price, volume), volume.count()};
+        Sample evicted{0, 0};
+        if (window_.push(sample, evicted)) {
+            notional_ -= evicted.notional;
+            volume_ -= evicted.volume;
+        }
+        notional_ += sample.notional;
+        volume_ += sample.volume;
+    }
+
+    // VWAP in ticks, which may fall between two ticks
+    double value() const { return volume_ > 0 ? static_cast<double>(notional_) / volume_ : 0.0; }
+    int64_t volume() const { return volume_; }
+    size_t size() const { return window_.size(); }
+    bool ready() const { return window_.full(); }
+
+    void clear() {
+        window_.clear();
+        notional_ = 0;
+        volume_ = 0;
+    }
+
+private:
+    struct Sample {
+        int64_t notional;   // Tick-lots
+        int64_t volume;     // Lots
+    };
+
+    RollingWindow<Sample> window_;
+    int64_t notional_{0};
+    int64_t volume_{0};
+};
+
+#endif // ROLLING_STATISTICS_H
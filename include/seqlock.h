@@ -0,0 +1,88 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include "common_types.h"
+#include "wait_strategy.h"
+
+// Sequence lock around a trivially copyable value. Readers never block
+// writers and never write shared memory; they retry if a write overlapped
+// their copy. Concurrent writers serialize on the sequence word.
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock values must be trivially copyable");
+
+public:
+    Seqlock() : value_() {}
+
+    void store(const T& value) {
+        // Take the write side by moving the sequence from even to odd
+        uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (!(seq & 1) && sequence_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire)) {
+                break;
+            }
+            cpuRelax();
+            seq = sequence_.load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&value_, &value, sizeof(T));
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Store for callers that already guarantee a single writer at a time;
+    // skips the compare-and-swap
+    void storeExclusive(const T& value) {
+        uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&value_, &value, sizeof(T));
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const {
+        T result;
+        while (!tryLoad(result)) {
+            cpuRelax();
+        }
+        return result;
+    }
+
+    // Value together with the version() it was written at
+    T load(uint64_t& version) const {
+        T result;
+        while (!tryLoad(result, version)) {
+            cpuRelax();
+        }
+        return result;
+    }
+
+    // Single read attempt, false if a write was in progress
+    bool tryLoad(T& result) const {
+        uint64_t version;
+        return tryLoad(result, version);
+    }
+
+    bool tryLoad(T& result, uint64_t& version) const {
+        uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::memcpy(&result, &value_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        version = before >> 1;
+        return sequence_.load(std::memory_order_relaxed) == before;
+    }
+
+    // Number of completed writes
+    uint64_t version() const { return sequence_.load(std::memory_order_acquire) >> 1; }
+
+private:
+    std::atomic<uint64_t> sequence_{0};
+    T value_;
+};
+
+#endif // SEQLOCK_H
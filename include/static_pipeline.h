@@ -0,0 +1,116 @@
+#ifndef STATIC_PIPELINE_H
+#define STATIC_PIPELINE_H
+
+#include <tuple>
+#include <utility>
+#include <cstddef>
+#include "common_types.h"
+#include "strategy_engine.h"
+
+// Optional CRTP base for strategies composed into a StaticPipeline. It
+// supplies the defaults the pipeline expects, so a strategy only has to
+// define onTick() and emitSignals(). Nothing here is virtual.
+template <typename Derived>
+class StaticStrategy {
+public:
+    bool isActive() const { return true; }
+    void onOrderUpdate(const Order&) {}
+
+protected:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+// Signal handler that gates orders through a risk check before passing them
+// on, e.g. StaticRiskGate<RiskManagement, decltype(submit)>. Both stages are
+// concrete types, so the whole chain is visible to the optimizer.
+template <typename Risk, typename Next>
+class StaticRiskGate {
+public:
+    StaticRiskGate(Risk& risk, Next next) : risk_(risk), next_(std::move(next)) {}
+
+    void operator()(const Order& order) {
+        if (risk_.checkOrder(order)) {
+            next_(order);
+        } else {
+            rejected_++;
+        }
+    }
+
+    uint64_t getRejected() const { return rejected_; }
+
+private:
+    Risk& risk_;
+    Next next_;
+    uint64_t rejected_{0};
+};
+
+// Tick -> strategies -> signal handler, wired at compile time. The strategy
+// set is a tuple of concrete types visited with fold expressions and the
+// handler is a plain callable, so there are no virtual calls or
+// std::function hops and the compiler can inline end to end. This is the
+// static counterpart of StrategyEngine for a strategy set that is known at
+// build time. Strategies must provide
+//     bool isActive() const
+//     void onTick(const Tick&)
+//     void onOrderUpdate(const Order&)
+//     void emitSignals(SignalSink&)
+// Existing Strategy subclasses qualify; marking them final lets the compiler
+// devirtualize their calls. Not thread-safe: feed it from one thread.
+template <typename SignalHandler, typename... Strategies>
+class StaticPipeline {
+public:
+    StaticPipeline(SignalHandler handler, Strategies... strategies)
+        : handler_(std::move(handler)), strategies_(std::move(strategies)...) {}
+
+    void processTick(const Tick& tick) {
+        std::apply([this, &tick](Strategies&... strategy) { (runStrategy(strategy, tick), ...); }, strategies_);
+    }
+
+    // Matches TickBatchCallback
+    void processTicks(const Tick* ticks, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            processTick(ticks[i]);
+        }
+    }
+
+    void processOrderUpdate(const Order& order) {
+        std::apply([&order](Strategies&... strategy) { (strategy.onOrderUpdate(order), ...); }, strategies_);
+    }
+
+    // Access a strategy by position
+    template <size_t I>
+    auto& getStrategy() { return std::get<I>(strategies_); }
+
+    SignalHandler& getHandler() { return handler_; }
+
+    static constexpr size_t getStrategyCount() { return sizeof...(Strategies); }
+
+private:
+    template <typename S>
+    void runStrategy(S& strategy, const Tick& tick) {
+        if (!strategy.isActive()) {
+            return;
+        }
+        strategy.onTick(tick);
+        strategy.emitSignals(sink_);
+        if (!sink_.empty()) {
+            for (const auto& signal : sink_) {
+                handler_(signal);
+            }
+            sink_.clear();
+        }
+    }
+
+    SignalHandler handler_;
+    std::tuple<Strategies...> strategies_;
+    SignalSink sink_;
+};
+
+// Deduce the pipeline type from its parts
+template <typename SignalHandler, typename... Strategies>
+StaticPipeline<SignalHandler, Strategies...> makeStaticPipeline(SignalHandler handler, Strategies... strategies) {
+    return StaticPipeline<SignalHandler, Strategies...>(std::move(handler), std::move(strategies)...);
+}
+
+#endif // STATIC_PIPELINE_H
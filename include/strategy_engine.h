@@ -9,6 +9,37 @@
 #include <atomic>
 #include "common_types.h"
 #include "config.h"
+#include "rolling_statistics.h"
+#include "instrument_table.h"
+#include "thread_pool.h"
+#include "epoch_reclaimer.h"
+
+// Reusable buffer strategies emit signals into. The engine owns one per
+// strategy and clears it after draining, so its storage is kept and steady
+// state emission never allocates.
+class SignalSink {
+public:
+    explicit SignalSink(size_t initial_capacity = 16) { signals_.reserve(initial_capacity); }
+
+    // Signals are stamped with the id of the strategy the sink belongs to
+    void emit(const Order& order) {
+        signals_.push_back(order);
+        signals_.back().strategy_id = strategy_id_;
+    }
+
+    const Order* begin() const { return signals_.data(); }
+    const Order* end() const { return signals_.data() + signals_.size(); }
+    size_t size() const { return signals_.size(); }
+    bool empty() const { return signals_.empty(); }
+    void clear() { signals_.clear(); }
+
+    StrategyId getStrategyId() const { return strategy_id_; }
+    void setStrategyId(StrategyId strategy_id) { strategy_id_ = strategy_id; }
+
+private:
+    std::vector<Order> signals_;
+    StrategyId strategy_id_{0};
+};
 
 // Base strategy interface
 class Strategy {
@@ -17,24 +48,65 @@ public:
     
     virtual void onTick(const Tick& tick) = 0;
     virtual void onOrderUpdate(const Order& order) = 0;
-    virtual std::vector<Order> generateSignals() = 0;
+    
+    // Emit any signals after a tick. The default forwards to the allocating
+    // generateSignals() so existing strategies keep working unchanged.
+    virtual void emitSignals(SignalSink& sink) {
+        for (const auto& signal : generateSignals()) {
+            sink.emit(signal);
+        }
+    }
+    
+    // Legacy signal API, only called through the default emitSignals()
+    virtual std::vector<Order> generateSignals() { return {}; }
     virtual std::string getName() const = 0;
     virtual bool isActive() const = 0;
+    
+    // Instruments whose ticks and order updates this strategy wants, read
+    // once at registration. Empty means every instrument.
+    virtual std::vector<InstrumentId> getInstruments() const { return {}; }
 };
 
+// Runs registered strategies on market data and order updates.
+//
+// The strategy set can change while ticks flow. Control operations
+// (register, unregister, pause, resume and the queries) work on a private
+// registry under their own mutex and publish immutable routing lists with
+// copy-on-write; the data path reads whatever lists are current inside an
+// epoch guard and never waits for a control operation. Lists and strategies
+// that are swapped out are destroyed only once no dispatch can still be
+// using them. Dispatching calls are serialized among themselves, since a
+// strategy is only ever run by one thread at a time.
 class StrategyEngine {
 public:
     using SignalCallback = std::function<void(const Order&)>;
 
+    // Uses SystemConfig::strategy_threads workers
     StrategyEngine();
+    
+    // Explicit worker count, 0 for serial execution on the caller
+    explicit StrategyEngine(size_t strategy_threads);
     ~StrategyEngine();
 
     // Initialize the strategy engine
     bool initialize(SignalCallback callback);
 
-    // Register a new strategy
+    // Register a new strategy, live from the next tick
     bool registerStrategy(std::unique_ptr<Strategy> strategy);
 
+    // Remove a strategy; it stops receiving events from the next tick and is
+    // destroyed once any dispatch still running it has finished. By name
+    // removes the earliest registered match.
+    bool unregisterStrategy(Strategy* strategy);
+    bool unregisterStrategy(const std::string& name);
+
+    // Suspend or resume delivery of ticks and order updates to a strategy
+    // without losing its state
+    bool pauseStrategy(Strategy* strategy);
+    bool pauseStrategy(const std::string& name);
+    bool resumeStrategy(Strategy* strategy);
+    bool resumeStrategy(const std::string& name);
+
     // Start all strategies
     void start();
 
@@ -44,21 +116,106 @@ public:
     // Process incoming market data
     void processTick(const Tick& tick);
 
+    // Process a batch of market data against one snapshot of the strategy set
+    void processTicks(const Tick* ticks, size_t count);
+    
+    // Whether strategies run on the strategy_threads pool
+    bool isParallel() const { return thread_pool_ != nullptr; }
+
     // Process order updates
     void processOrderUpdate(const Order& order);
 
-    // Get active strategies count
+    // Get active strategies count, paused strategies are not counted
     size_t getActiveStrategiesCount() const;
 
-    // Get strategy by name
+    // Registered strategies, paused or not
+    size_t getStrategyCount() const;
+
+    // Get strategy by name. The pointer stays valid until the strategy is
+    // unregistered.
     Strategy* getStrategyByName(const std::string& name);
 
-private:
-    // Vector to hold registered strategies
-    std::vector<std::unique_ptr<Strategy>> strategies_;
+    // Whether a registered strategy is paused
+    bool isPaused(Strategy* strategy) const;
 
-    // Thread safety
-    mutable std::mutex strategies_mutex_;
+    // Id stamped on a registered strategy's signals (Order::strategy_id),
+    // 0 if it is not registered. Ids are never reused.
+    StrategyId getStrategyId(Strategy* strategy) const;
+
+private:
+    // A registered strategy with its dispatch scratch
+    struct StrategySlot;
+
+    // Strategies that receive one instrument's events, in registration order
+    using RouteList = std::vector<StrategySlot*>;
+
+    // Signal produced in parallel mode, tagged for the deterministic merge
+    struct PendingSignal {
+        size_t tick_index;
+        uint64_t sequence;      // Registration order of the emitting strategy
+        uint32_t emit_index;    // Position in the merge buffer, keeps a strategy's own order
+        Order order;
+    };
+
+    struct StrategySlot {
+        std::unique_ptr<Strategy> strategy;
+        uint64_t sequence;                      // Registration order
+        std::vector<InstrumentId> instruments;  // As requested at registration, empty for all
+        std::atomic<bool> paused{false};
+
+        // Dispatch scratch, only touched under dispatch_mutex_
+        SignalSink sink;
+        std::vector<uint32_t> ticks;        // Batch indices routed to the strategy
+        std::vector<PendingSignal> signals; // Parallel mode output awaiting the merge
+    };
+
+    // Strategies that receive an instrument's events; the caller must hold
+    // an epoch guard for as long as it uses the list
+    const RouteList& routeFor(InstrumentId instrument_id) const {
+        const std::atomic<const RouteList*>* route = routes_.find(instrument_id);
+        const RouteList* list = route ? route->load(std::memory_order_acquire) : nullptr;
+        return list ? *list : *wildcard_.load(std::memory_order_acquire);
+    }
+
+    // Run every interested active strategy on one tick.
+    // An epoch guard and dispatch_mutex_ must be held.
+    void dispatchTick(const Tick& tick);
+
+    // Run a batch across the thread pool, then emit signals ordered by
+    // (tick, registration order) exactly as the serial path would.
+    // An epoch guard and dispatch_mutex_ must be held.
+    void dispatchParallel(const Tick* ticks, size_t count);
+
+    // Registry lookups, registry_mutex_ must be held
+    StrategySlot* findSlot(const Strategy* strategy) const;
+    StrategySlot* findSlot(const std::string& name) const;
+
+    // Publish a new list in place of the current one and retire the old.
+    // registry_mutex_ must be held.
+    void publish(std::atomic<const RouteList*>& target, RouteList* list);
+
+    bool unregisterSlot(StrategySlot* slot);
+    bool setPaused(StrategySlot* slot, bool paused);
+
+    // Registered strategies in registration order, owned here until retired.
+    // Only the control path reads or writes the registry.
+    std::vector<std::unique_ptr<StrategySlot>> slots_;
+    uint64_t next_sequence_{0};
+    mutable std::mutex registry_mutex_;
+
+    // Published routing read by the data path. An instrument with no list
+    // has no specific subscribers and falls through to wildcard_.
+    InstrumentTable<std::atomic<const RouteList*>> routes_;
+    std::atomic<const RouteList*> wildcard_;
+    EpochReclaimer reclaimer_;
+
+    // Parallel execution, only when strategy_threads > 0
+    std::unique_ptr<ThreadPool> thread_pool_;
+    std::vector<StrategySlot*> batch_strategies_;
+    std::vector<PendingSignal> merged_signals_;
+
+    // Serializes dispatching threads; control operations never take it
+    std::mutex dispatch_mutex_;
 
     // Callback for generated signals
     SignalCallback signal_callback_;
@@ -68,24 +225,27 @@ private:
 };
 
 // Example concrete strategy class
-class SimpleMeanReversionStrategy : public Strategy {
+class SimpleMeanReversionStrategy final : public Strategy {
 public:
-    explicit SimpleMeanReversionStrategy(InstrumentId instrument_id, double threshold);
+    SimpleMeanReversionStrategy(InstrumentId instrument_id, double threshold, size_t window_size = 100);
     
     void onTick(const Tick& tick) override;
     void onOrderUpdate(const Order& order) override;
-    std::vector<Order> generateSignals() override;
+    void emitSignals(SignalSink& sink) override;
     std::string getName() const override { return "SimpleMeanReversion"; }
     bool isActive() const override { return active_; }
+    std::vector<InstrumentId> getInstruments() const override { return {instrument_id_}; }
 
 private:
     InstrumentId instrument_id_;
     double threshold_;
+    Quantity order_quantity_;   // 100 shares in lots
     bool active_{true};
     
-    // Simple moving average tracking
-    std::vector<Price> prices_;
-    size_t window_size_{100};
+    // Simple moving average of bid + ask in ticks, twice the mid, so the
+    // window sums stay exact
+    BasicRollingMean<int64_t> mid_prices_;
+    bool has_new_price_{false};   // Only evaluate after a tick for our instrument
     
     // Last order tracking
     OrderId last_order_id_{0};
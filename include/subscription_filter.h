@@ -0,0 +1,111 @@
+#ifndef SUBSCRIPTION_FILTER_H
+#define SUBSCRIPTION_FILTER_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include "common_types.h"
+
+// Read-mostly set of subscribed instruments, stored as a dense bitmap keyed
+// by instrument id. Segments of the bitmap are allocated lazily the first time
+// an id in their range is subscribed and are never freed before destruction,
+// so the tick path reads with two plain loads and no lock while control
+// threads subscribe and unsubscribe concurrently.
+class SubscriptionFilter {
+public:
+    explicit SubscriptionFilter(size_t max_instruments)
+        : max_instruments_(max_instruments),
+          segment_count_((max_instruments + BITS_PER_SEGMENT - 1) / BITS_PER_SEGMENT),
+          segments_(new std::atomic<Segment*>[segment_count_]) {
+        for (size_t i = 0; i < segment_count_; ++i) {
+            segments_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~SubscriptionFilter() {
+        for (size_t i = 0; i < segment_count_; ++i) {
+            delete segments_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    SubscriptionFilter(const SubscriptionFilter&) = delete;
+    SubscriptionFilter& operator=(const SubscriptionFilter&) = delete;
+
+    // Hot path: is the instrument subscribed
+    bool contains(InstrumentId instrument_id) const {
+        if (instrument_id >= max_instruments_) {
+            return false;
+        }
+        const Segment* segment = segments_[instrument_id / BITS_PER_SEGMENT].load(std::memory_order_acquire);
+        if (!segment) {
+            return false;
+        }
+        size_t bit = instrument_id % BITS_PER_SEGMENT;
+        return (segment->words[bit / 64].load(std::memory_order_relaxed) >> (bit % 64)) & 1;
+    }
+
+    // Returns true if the instrument was newly added
+    bool add(InstrumentId instrument_id) {
+        if (instrument_id >= max_instruments_) {
+            return false;
+        }
+        Segment* segment = getOrCreateSegment(instrument_id / BITS_PER_SEGMENT);
+        size_t bit = instrument_id % BITS_PER_SEGMENT;
+        uint64_t mask = uint64_t{1} << (bit % 64);
+        bool added = !(segment->words[bit / 64].fetch_or(mask, std::memory_order_release) & mask);
+        if (added) {
+            count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return added;
+    }
+
+    // Returns true if the instrument was present
+    bool remove(InstrumentId instrument_id) {
+        if (instrument_id >= max_instruments_) {
+            return false;
+        }
+        Segment* segment = segments_[instrument_id / BITS_PER_SEGMENT].load(std::memory_order_acquire);
+        if (!segment) {
+            return false;
+        }
+        size_t bit = instrument_id % BITS_PER_SEGMENT;
+        uint64_t mask = uint64_t{1} << (bit % 64);
+        bool removed = (segment->words[bit / 64].fetch_and(~mask, std::memory_order_release) & mask) != 0;
+        if (removed) {
+            count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return removed;
+    }
+
+    size_t size() const { return count_.load(std::memory_order_relaxed); }
+    size_t maxInstruments() const { return max_instruments_; }
+
+private:
+    static constexpr size_t BITS_PER_SEGMENT = 1 << 16;
+
+    struct Segment {
+        std::atomic<uint64_t> words[BITS_PER_SEGMENT / 64] = {};
+    };
+
+    Segment* getOrCreateSegment(size_t index) {
+        Segment* segment = segments_[index].load(std::memory_order_acquire);
+        if (segment) {
+            return segment;
+        }
+
+        // Race to install a new segment, losers free theirs
+        Segment* fresh = new Segment();
+        if (segments_[index].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel)) {
+            return fresh;
+        }
+        delete fresh;
+        return segment;
+    }
+
+    const size_t max_instruments_;
+    const size_t segment_count_;
+    std::unique_ptr<std::atomic<Segment*>[]> segments_;
+    std::atomic<size_t> count_{0};
+};
+
+#endif // SUBSCRIPTION_FILTER_H
@@ -0,0 +1,91 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <type_traits>
+#include "common_types.h"
+#include "wait_strategy.h"
+
+// Fork-join pool for running many independent tasks across cores. Each
+// worker owns a deque: it pops its own tasks from the back and, when empty,
+// steals from the front of another worker's deque, so uneven task costs
+// balance out without a shared queue becoming the bottleneck. The thread
+// calling parallelFor also executes tasks until the whole range is done.
+class ThreadPool {
+public:
+    ThreadPool(size_t thread_count, WaitStrategy wait_strategy, uint32_t spin_iterations);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Run fn(i) for every i in [0, count) and return once all calls finished.
+    // Calls may run concurrently and in any order. Only one parallelFor may
+    // be in flight at a time.
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn) {
+        using FnType = typename std::remove_reference<Fn>::type;
+        run(count, [](void* context, size_t index) { (*static_cast<FnType*>(context))(index); },
+            const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+    size_t getThreadCount() const { return workers_.size(); }
+    uint64_t getTasksExecuted() const { return tasks_executed_; }
+    uint64_t getTasksStolen() const { return tasks_stolen_; }
+
+private:
+    using TaskFn = void (*)(void*, size_t);
+
+    struct Task {
+        TaskFn fn;
+        void* context;
+        size_t index;
+    };
+
+    // Growable ring of tasks; the owner takes from the back, thieves from the front
+    struct alignas(CACHE_LINE_SIZE) WorkQueue {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        size_t head{0};
+        size_t count{0};
+
+        void push(const Task& task);
+        bool popBack(Task& task);
+        bool popFront(Task& task);
+    };
+
+    struct Worker {
+        Worker(WaitStrategy wait_strategy, uint32_t spin_iterations)
+            : waiter(wait_strategy, spin_iterations) {}
+
+        WorkQueue queue;
+        ConsumerWaiter waiter;
+        std::thread thread;
+    };
+
+    void run(size_t count, TaskFn fn, void* context);
+    void workerThread(size_t self);
+
+    // Take a task from queue `self` or steal one from another queue
+    bool findTask(size_t self, Task& task);
+    void execute(const Task& task);
+
+    // Queue 0..N-1 belong to workers, queue N to the calling thread
+    std::vector<std::unique_ptr<Worker>> workers_;
+    WorkQueue caller_queue_;
+    WorkQueue& queueOf(size_t index) { return index < workers_.size() ? workers_[index]->queue : caller_queue_; }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> pending_{0};   // Tasks not yet finished
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> queued_{0};    // Tasks not yet taken
+    std::atomic<bool> running_{true};
+
+    std::atomic<uint64_t> tasks_executed_{0};
+    std::atomic<uint64_t> tasks_stolen_{0};
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,96 @@
+#ifndef TICK_JOURNAL_H
+#define TICK_JOURNAL_H
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "common_types.h"
+#include "journal.h"
+#include "ring_buffer.h"
+#include "wait_strategy.h"
+
+class MarketDataHandler;
+
+// Captures ticks into an append-only journal. record() only pushes into a
+// bounded ring; a dedicated writer thread copies ticks into the mapped
+// segments, so capture never does I/O on the caller's thread.
+class TickJournalWriter {
+public:
+    TickJournalWriter(const std::string& path_prefix, size_t segment_size, size_t queue_capacity);
+    ~TickJournalWriter();
+
+    // Open the journal and start the writer thread
+    bool start();
+
+    // Drain pending ticks, stop the writer thread and close the journal
+    void stop();
+
+    // Hot path: queue a tick for writing, returns false if it was dropped
+    bool record(const Tick& tick) {
+        if (!ring_.tryPush(tick)) {
+            ticks_dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        waiter_.notify();
+        return true;
+    }
+
+    // Get statistics
+    uint64_t getTicksRecorded() const { return ticks_recorded_; }
+    uint64_t getTicksDropped() const { return ticks_dropped_; }
+
+private:
+    void writerThread();
+    size_t drain();
+
+    JournalWriter journal_;
+    BoundedRingBuffer<Tick> ring_;
+    ConsumerWaiter waiter_;
+    std::unique_ptr<std::thread> writer_thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> ticks_recorded_{0};
+    std::atomic<uint64_t> ticks_dropped_{0};
+};
+
+// Zero-copy view of a tick journal
+class TickJournalReader {
+public:
+    explicit TickJournalReader(const std::string& path_prefix);
+
+    bool open() { return journal_.open(); }
+    void close() { journal_.close(); }
+
+    uint64_t getTickCount() const { return journal_.getRecordCount(); }
+    size_t getSegmentCount() const { return journal_.getSegmentCount(); }
+
+    // Ticks of one segment, served directly from the mapping
+    const Tick* segmentTicks(size_t segment, uint64_t& count) const {
+        count = journal_.segmentRecordCount(segment);
+        return static_cast<const Tick*>(journal_.segmentRecords(segment));
+    }
+
+    // Visit every tick in journal order; stop early if fn returns false
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t segment = 0; segment < getSegmentCount(); ++segment) {
+            uint64_t count = 0;
+            const Tick* ticks = segmentTicks(segment, count);
+            for (uint64_t i = 0; i < count; ++i) {
+                if (!fn(ticks[i])) {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    JournalReader journal_;
+};
+
+// Replay a journal through MarketDataHandler::addTick. A speed of 0 replays
+// as fast as possible, otherwise the original gaps between ticks are divided
+// by speed (1.0 = real time). Returns the number of ticks accepted.
+uint64_t replayTickJournal(const TickJournalReader& reader, MarketDataHandler& handler, double speed = 0.0);
+
+#endif // TICK_JOURNAL_H
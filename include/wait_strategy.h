@@ -0,0 +1,83 @@
+#ifndef WAIT_STRATEGY_H
+#define WAIT_STRATEGY_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include "common_types.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Hint to the CPU that we are in a spin loop
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Idle policy for a queue consumer. The consumer calls wait() each time it
+// finds its queue empty and reset() once it gets work again; producers call
+// notify() after publishing, which costs a single load unless the consumer is
+// actually parked.
+class ConsumerWaiter {
+public:
+    ConsumerWaiter(WaitStrategy strategy, uint32_t spin_iterations)
+        : strategy_(strategy), spin_iterations_(spin_iterations) {}
+
+    // Idle once; has_work is re-checked before parking to avoid lost wake-ups.
+    // A parked consumer also wakes after max_park, for consumers with
+    // deadlines of their own.
+    template <typename Predicate>
+    void wait(Predicate has_work, std::chrono::nanoseconds max_park = std::chrono::milliseconds(10)) {
+        if (strategy_ == WaitStrategy::BUSY_POLL || spins_ < spin_iterations_) {
+            ++spins_;
+            cpuRelax();
+            return;
+        }
+
+        if (strategy_ == WaitStrategy::SPIN_THEN_YIELD) {
+            std::this_thread::yield();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        parked_.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_work()) {
+            // Timed wait is only a safety net, producers wake us explicitly
+            cv_.wait_for(lock, max_park);
+        }
+        parked_.store(false, std::memory_order_relaxed);
+    }
+
+    // Consumer found work, start spinning again next time it idles
+    void reset() { spins_ = 0; }
+
+    // Wake the consumer if it is parked
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+    }
+
+    WaitStrategy getStrategy() const { return strategy_; }
+
+private:
+    const WaitStrategy strategy_;
+    const uint32_t spin_iterations_;
+    uint32_t spins_{0};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> parked_{false};
+};
+
+#endif // WAIT_STRATEGY_H
@@ -0,0 +1,226 @@
+#include "../include/backtest_engine.h"
+#include "../include/tick_journal.h"
+#include "../include/clock.h"
+#include <chrono>
+#include <algorithm>
+
+BacktestEngine::BacktestEngine(const BacktestConfig& config)
+    : config_(config),
+      quotes_(ConfigManager::getInstance().max_instruments),
+      risk_management_(std::make_unique<RiskManagement>()),
+      strategy_engine_(std::make_unique<StrategyEngine>(0)),
+      instruments_(ConfigManager::getInstance().max_instruments) {
+    risk_management_->initialize(config_.risk_limits);
+    risk_management_->setQuoteSource(&quotes_);
+    risk_management_->setLogRejections(false);
+
+    strategy_engine_->initialize([this](const Order& signal) { onSignal(signal); });
+    strategy_engine_->start();
+}
+
+BacktestEngine::~BacktestEngine() {
+    strategy_engine_->stop();
+}
+
+bool BacktestEngine::addStrategy(std::unique_ptr<Strategy> strategy) {
+    return strategy_engine_->registerStrategy(std::move(strategy));
+}
+
+BacktestStats BacktestEngine::run(const Tick* ticks, size_t count) {
+    Clock::SimulatedTime simulated(&now_);
+    auto wall_start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < count; ++i) {
+        processTick(ticks[i]);
+    }
+
+    stats_.elapsed_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    return getStats();
+}
+
+BacktestStats BacktestEngine::run(const TickJournalReader& journal) {
+    Clock::SimulatedTime simulated(&now_);
+    auto wall_start = std::chrono::steady_clock::now();
+
+    // Ticks are read straight out of the journal mapping
+    for (size_t segment = 0; segment < journal.getSegmentCount(); ++segment) {
+        uint64_t count = 0;
+        const Tick* ticks = journal.segmentTicks(segment, count);
+        for (uint64_t i = 0; i < count; ++i) {
+            processTick(ticks[i]);
+        }
+    }
+
+    stats_.elapsed_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    return getStats();
+}
+
+BacktestStats BacktestEngine::getStats() const {
+    BacktestStats stats = stats_;
+    stats.total_pnl = stats.realized_pnl + stats.unrealized_pnl;
+    stats.ticks_per_second = stats.elapsed_seconds > 0 ? stats.ticks_processed / stats.elapsed_seconds : 0.0;
+    return stats;
+}
+
+int64_t BacktestEngine::getPosition(InstrumentId instrument_id) const {
+    const InstrumentState* state = instruments_.find(instrument_id);
+    return state ? state->position.quantity : 0;
+}
+
+void BacktestEngine::processTick(const Tick& tick) {
+    // Simulated time follows the data and never runs backwards
+    Timestamp tick_time = tick.exchange_timestamp ? tick.exchange_timestamp : tick.receive_timestamp;
+    if (tick_time > now_) {
+        now_ = tick_time;
+    }
+    if (stats_.ticks_processed++ == 0) {
+        stats_.first_tick_time = now_;
+    }
+    stats_.last_tick_time = now_;
+
+    // Orders that arrived before this tick trade against the previous quotes
+    executeArrivals(now_);
+
+    InstrumentState* state = instruments_.getOrCreate(tick.instrument_id);
+    if (!state) {
+        return;
+    }
+    if (state->spec.tick_size == 0.0) {
+        state->spec = InstrumentSpecs::getInstance().getSpec(tick.instrument_id);
+        state->position.instrument_id = tick.instrument_id;
+    }
+    state->quote = tick;
+    state->has_quote = tick.bid_price.count() > 0 && tick.ask_price.count() > 0;
+    quotes_.update(tick);
+
+    if (state->position.quantity != 0 && state->has_quote) {
+        markPosition(*state);
+        updateEquity();
+    }
+
+    strategy_engine_->processTick(tick);
+
+    for (const Order& rejected : rejected_) {
+        strategy_engine_->processOrderUpdate(rejected);
+    }
+    rejected_.clear();
+
+    // Orders with no latency reach the exchange before the next event
+    if (config_.order_latency_ns <= 0) {
+        executeArrivals(now_);
+    }
+}
+
+void BacktestEngine::onSignal(const Order& signal) {
+    stats_.signals++;
+
+    PendingOrder pending;
+    pending.order = signal;
+    pending.order.order_id = next_order_id_++;
+    pending.order.filled_quantity = Quantity(0);
+    pending.order.state = OrderState::NEW;
+    pending.order.timestamp = now_;
+
+    if (!risk_management_->checkOrder(pending.order)) {
+        // Reported once the strategy engine has finished dispatching this tick
+        stats_.orders_rejected++;
+        pending.order.state = OrderState::REJECTED;
+        rejected_.push_back(pending.order);
+        return;
+    }
+
+    pending.arrival_time = now_ + static_cast<Timestamp>(std::max<int64_t>(config_.order_latency_ns, 0));
+    pending_.push_back(pending);
+}
+
+void BacktestEngine::executeArrivals(Timestamp time) {
+    while (pending_head_ < pending_.size() && pending_[pending_head_].arrival_time <= time) {
+        Order& order = pending_[pending_head_].order;
+        fillOrder(order);
+        strategy_engine_->processOrderUpdate(order);
+        pending_head_++;
+    }
+
+    // Reclaim the consumed prefix once the queue drains
+    if (pending_head_ == pending_.size()) {
+        pending_.clear();
+        pending_head_ = 0;
+    }
+}
+
+void BacktestEngine::fillOrder(Order& order) {
+    InstrumentState* state = instruments_.find(order.instrument_id);
+    if (!state || !state->has_quote || order.quantity.count() <= 0) {
+        stats_.orders_unfilled++;
+        order.state = OrderState::CANCELLED;
+        return;
+    }
+
+    bool buy = order.side == OrderSide::BUY;
+    Price touch = buy ? state->quote.ask_price : state->quote.bid_price;
+
+    // Limit orders are immediate-or-cancel against the touch on arrival
+    if (order.type == OrderType::LIMIT && order.price.count() > 0 && (buy ? touch > order.price : touch < order.price)) {
+        stats_.orders_unfilled++;
+        order.state = OrderState::CANCELLED;
+        return;
+    }
+
+    order.price = touch;
+    order.filled_quantity = order.quantity;
+    order.state = OrderState::FILLED;
+    order.timestamp = now_;
+
+    applyFill(*state, order);
+    risk_management_->updatePosition(order);
+}
+
+void BacktestEngine::applyFill(InstrumentState& state, const Order& order) {
+    const InstrumentSpec& spec = state.spec;
+    int64_t lots = order.filled_quantity.count();
+    double value = spec.toValue(notional(order.price, order.filled_quantity));
+    double commission = spec.toDecimal(order.filled_quantity) * config_.commission_per_share;
+    double slippage = value * config_.slippage_bps / 10000.0;
+
+    stats_.fills++;
+    stats_.traded_value += value;
+    stats_.commission += commission;
+    stats_.slippage += slippage;
+    stats_.realized_pnl -= commission + slippage;
+
+    // Reducing, closing or flipping realizes P&L on the closed part
+    bool closing = state.position.quantity != 0 &&
+                   (state.position.quantity > 0) != (order.side == OrderSide::BUY);
+    int64_t realized = state.position.applyFill(order.side == OrderSide::BUY ? lots : -lots, order.price);
+    if (closing) {
+        stats_.realized_pnl += spec.toValue(realized);
+        stats_.closing_trades++;
+        if (realized > 0) {
+            stats_.winning_trades++;
+        } else if (realized < 0) {
+            stats_.losing_trades++;
+        }
+    }
+
+    markPosition(state);
+    updateEquity();
+}
+
+void BacktestEngine::markPosition(InstrumentState& state) {
+    // At the current mid, which may fall between two ticks
+    double mid = midPrice(state.quote.bid_price, state.quote.ask_price);
+    double tick_lots = mid * static_cast<double>(state.position.quantity) - static_cast<double>(state.position.cost);
+    double unrealized = tick_lots * state.spec.tick_size * state.spec.lot_size;
+    stats_.unrealized_pnl += unrealized - state.unrealized_pnl;
+    state.unrealized_pnl = unrealized;
+}
+
+void BacktestEngine::updateEquity() {
+    double total = stats_.realized_pnl + stats_.unrealized_pnl;
+    if (total > peak_pnl_) {
+        peak_pnl_ = total;
+    }
+    if (peak_pnl_ - total > stats_.max_drawdown) {
+        stats_.max_drawdown = peak_pnl_ - total;
+    }
+}
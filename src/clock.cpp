@@ -0,0 +1,147 @@
+#include "../include/clock.h"
+#include "../include/config.h"
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+// Invariant TSC runs at a constant rate in all P/C-states (CPUID 0x80000007 EDX bit 8)
+bool hasInvariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+// Take a (tsc, realtime) pair, keeping the tightest of a few attempts
+void samplePair(uint64_t& tsc, uint64_t& ns) {
+    uint64_t best_gap = UINT64_MAX;
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        uint64_t before = Clock::readTsc();
+        uint64_t realtime = Clock::realtimeNow();
+        uint64_t after = Clock::readTsc();
+        if (after - before < best_gap) {
+            best_gap = after - before;
+            tsc = before + (after - before) / 2;
+            ns = realtime;
+        }
+    }
+}
+}
+
+Timestamp Clock::realtimeNow() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<Timestamp>(ts.tv_sec) * 1000000000ULL + static_cast<Timestamp>(ts.tv_nsec);
+}
+
+double Clock::getTscFrequencyGhz() {
+    State& state = instance();
+    if (!state.use_tsc) {
+        return 0.0;
+    }
+    return 4294967296.0 / static_cast<double>(state.calibration.load().ns_per_tick_q32);
+}
+
+Clock::State::State() {
+    use_tsc = hasInvariantTsc();
+    if (!use_tsc) {
+        return;
+    }
+
+    // Initial rate estimate over a short busy-wait window
+    samplePair(origin_tsc, origin_ns);
+    uint64_t end_tsc = 0;
+    uint64_t end_ns = 0;
+    do {
+        samplePair(end_tsc, end_ns);
+    } while (end_ns - origin_ns < 10000000ULL);
+
+    uint64_t elapsed_ticks = end_tsc - origin_tsc;
+    if (elapsed_ticks == 0) {
+        use_tsc = false;
+        return;
+    }
+
+    Calibration initial;
+    initial.base_tsc = end_tsc;
+    initial.base_ns = end_ns;
+    initial.ns_per_tick_q32 = static_cast<uint64_t>(
+        (static_cast<unsigned __int128>(end_ns - origin_ns) << 32) / elapsed_ticks);
+    calibration.store(initial);
+
+    int64_t interval_ms = ConfigManager::getInstance().clock_recalibration_interval_ms;
+    if (interval_ms > 0) {
+        slew_window_ns = static_cast<uint64_t>(interval_ms) * 1000000ULL;
+        recalibration_thread = std::thread(&State::recalibrationThread, this, std::chrono::milliseconds(interval_ms));
+    }
+}
+
+Clock::State::~State() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+        stopping = true;
+    }
+    stop_cv.notify_all();
+    if (recalibration_thread.joinable()) {
+        recalibration_thread.join();
+    }
+}
+
+void Clock::State::recalibrationThread(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(stop_mutex);
+    while (!stop_cv.wait_for(lock, interval, [this] { return stopping; })) {
+        recalibrate();
+    }
+}
+
+void Clock::State::recalibrate() {
+    if (!use_tsc || recalibrating.exchange(true, std::memory_order_acquire)) {
+        return; // Another thread is already on it
+    }
+
+    uint64_t tsc = 0;
+    uint64_t ns = 0;
+    samplePair(tsc, ns);
+
+    // Measuring the rate over the whole run keeps refining its precision
+    uint64_t rate = static_cast<uint64_t>(
+        (static_cast<unsigned __int128>(ns - origin_ns) << 32) / (tsc - origin_tsc));
+
+    // Never step backwards: if the TSC ran fast, hold the base at the current
+    // reading and run slower than the measured rate until the next
+    // recalibration, so the projection lands back on realtime by then
+    Calibration current = calibration.load();
+    uint64_t projected = current.base_ns + static_cast<uint64_t>(
+        (static_cast<unsigned __int128>(tsc - current.base_tsc) * current.ns_per_tick_q32) >> 32);
+    uint64_t base = ns;
+    if (projected > ns) {
+        base = projected;
+        uint64_t ahead = projected - ns;
+        uint64_t window = slew_window_ns;
+        if (window == 0 && ns > current.base_ns) {
+            window = ns - current.base_ns;
+        }
+        // Never slower than half speed; a larger lead is worked off over several intervals
+        uint64_t kept = ahead < window / 2 ? window - ahead : window / 2;
+        if (window > 0) {
+            rate = static_cast<uint64_t>(static_cast<unsigned __int128>(rate) * kept / window);
+        }
+    }
+
+    Calibration updated;
+    updated.base_tsc = tsc;
+    updated.base_ns = base;
+    updated.ns_per_tick_q32 = rate;
+    calibration.store(updated);
+
+    recalibrating.store(false, std::memory_order_release);
+}
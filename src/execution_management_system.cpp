@@ -2,8 +2,13 @@
 #include <iostream>
 
 ExecutionManagementSystem::ExecutionManagementSystem() {
-    outgoing_queue_ = std::make_unique<OutgoingOrderQueue>();
-    incoming_queue_ = std::make_unique<IncomingExecutionQueue>();
+    const SystemConfig& config = ConfigManager::getInstance();
+    outgoing_queue_ = std::make_unique<WorkQueue>(config.execution_queue_capacity,
+                                                  config.execution_wait_strategy,
+                                                  config.spin_iterations);
+    incoming_queue_ = std::make_unique<WorkQueue>(config.execution_queue_capacity,
+                                                  config.execution_wait_strategy,
+                                                  config.spin_iterations);
 }
 
 ExecutionManagementSystem::~ExecutionManagementSystem() {
@@ -32,16 +37,23 @@ bool ExecutionManagementSystem::sendOrderToMarket(const Order& order) {
         return false;
     }
     
-    // Add order to outgoing queue
-    {
-        std::lock_guard<std::mutex> lock(outgoing_queue_->mutex_);
-        outgoing_queue_->queue_.push(order);
+    if (!enqueue(*outgoing_queue_, order)) {
+        orders_rejected_++;
+        return false;
     }
     
     orders_sent_++;
     return true;
 }
 
+bool ExecutionManagementSystem::receiveExecution(const Order& execution) {
+    if (!running_) {
+        return false;
+    }
+    
+    return enqueue(*incoming_queue_, execution);
+}
+
 bool ExecutionManagementSystem::sendCancelToMarket(OrderId order_id) {
     if (!running_) {
         return false;
@@ -86,55 +98,57 @@ void ExecutionManagementSystem::stop() {
     
     outgoing_queue_->stopped_ = true;
     incoming_queue_->stopped_ = true;
+    
+    // Wake parked workers so they see the flag
+    outgoing_queue_->waiter_.notify();
+    incoming_queue_->waiter_.notify();
 }
 
-void ExecutionManagementSystem::sendWorker() {
+bool ExecutionManagementSystem::enqueue(WorkQueue& queue, const Order& order) {
+    if (!queue.ring_.tryPush(order)) {
+        return false;
+    }
+    
+    // Wake the worker if it is parked
+    queue.waiter_.notify();
+    return true;
+}
+
+bool ExecutionManagementSystem::dequeue(WorkQueue& queue, Order& order) {
     while (running_) {
-        // Check for orders to send
-        {
-            std::lock_guard<std::mutex> lock(outgoing_queue_->mutex_);
-            
-            if (!outgoing_queue_->queue_.empty()) {
-                Order order = outgoing_queue_->queue_.front();
-                outgoing_queue_->queue_.pop();
-                
-                // In a real implementation, this would send the order to the market
-                // For now, we'll just simulate successful sending
-                std::cout << "Sent order " << order.order_id << " to market " << static_cast<int>(order.market) << std::endl;
-                
-                // Simulate acknowledgment
-                order.state = OrderState::NEW;
-                if (execution_callback_) {
-                    execution_callback_(order);
-                }
-                
-                orders_acked_++;
-            }
+        if (queue.ring_.tryPop(order)) {
+            queue.waiter_.reset();
+            return true;
         }
         
-        // Small delay to prevent busy-waiting
-        std::this_thread::sleep_for(std::chrono::microseconds(10));
+        // Queue is empty, idle according to the configured wait strategy
+        queue.waiter_.wait([&queue] { return !queue.ring_.empty() || queue.stopped_; });
     }
+    return false;
 }
 
-void ExecutionManagementSystem::receiveWorker() {
-    while (running_) {
-        // Check for incoming executions
-        {
-            std::lock_guard<std::mutex> lock(incoming_queue_->mutex_);
-            
-            if (!incoming_queue_->queue_.empty()) {
-                Order execution = incoming_queue_->queue_.front();
-                incoming_queue_->queue_.pop();
-                
-                // Process the execution
-                if (execution_callback_) {
-                    execution_callback_(execution);
-                }
-            }
+void ExecutionManagementSystem::sendWorker() {
+    Order order;
+    while (dequeue(*outgoing_queue_, order)) {
+        // In a real implementation, this would send the order to the market
+        // For now, we'll just simulate successful sending and acknowledgment
+        order.state = OrderState::NEW;
+        if (execution_callback_) {
+            execution_callback_(order);
         }
         
-        // Small delay to prevent busy-waiting
-        std::this_thread::sleep_for(std::chrono::microseconds(10));
+        orders_acked_++;
+    }
+}
+
+void ExecutionManagementSystem::receiveWorker() {
+    Order execution;
+    while (dequeue(*incoming_queue_, execution)) {
+        executions_received_++;
+        
+        // Process the execution
+        if (execution_callback_) {
+            execution_callback_(execution);
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,396 @@
+#include "../include/factor_panel.h"
+#include "../include/clock.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+// Lane-wise operations used by the factor kernels. The kernels are written
+// once against this interface and instantiated for the widest instruction
+// set the build targets.
+struct ScalarOps {
+    using Vec = double;
+    using Mask = bool;
+    static constexpr size_t WIDTH = 1;
+
+    static Vec load(const double* p) { return *p; }
+    static void store(double* p, Vec v) { *p = v; }
+    static Vec set1(double x) { return x; }
+    static Vec add(Vec a, Vec b) { return a + b; }
+    static Vec sub(Vec a, Vec b) { return a - b; }
+    static Vec mul(Vec a, Vec b) { return a * b; }
+    static Vec div(Vec a, Vec b) { return a / b; }
+    static Vec sqrt(Vec a) { return std::sqrt(a); }
+    static Mask greater(Vec a, Vec b) { return a > b; }
+    static Mask both(Mask a, Mask b) { return a && b; }
+    static Vec select(Mask m, Vec a, Vec b) { return m ? a : b; }
+    static double sum(Vec a) { return a; }
+};
+
+#if defined(__AVX2__)
+struct Avx2Ops {
+    using Vec = __m256d;
+    using Mask = __m256d;
+    static constexpr size_t WIDTH = 4;
+
+    static Vec load(const double* p) { return _mm256_load_pd(p); }
+    static void store(double* p, Vec v) { _mm256_store_pd(p, v); }
+    static Vec set1(double x) { return _mm256_set1_pd(x); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static Vec div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+    static Vec sqrt(Vec a) { return _mm256_sqrt_pd(a); }
+    static Mask greater(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static Mask both(Mask a, Mask b) { return _mm256_and_pd(a, b); }
+    static Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_pd(b, a, m); }
+    static double sum(Vec a) {
+        __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+};
+#endif
+
+#if defined(__AVX512F__)
+struct Avx512Ops {
+    using Vec = __m512d;
+    using Mask = __mmask8;
+    static constexpr size_t WIDTH = 8;
+
+    static Vec load(const double* p) { return _mm512_load_pd(p); }
+    static void store(double* p, Vec v) { _mm512_store_pd(p, v); }
+    static Vec set1(double x) { return _mm512_set1_pd(x); }
+    static Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    static Vec div(Vec a, Vec b) { return _mm512_div_pd(a, b); }
+    static Vec sqrt(Vec a) { return _mm512_sqrt_pd(a); }
+    static Mask greater(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static Mask both(Mask a, Mask b) { return a & b; }
+    static Vec select(Mask m, Vec a, Vec b) { return _mm512_mask_blend_pd(m, b, a); }
+    static double sum(Vec a) { return _mm512_reduce_add_pd(a); }
+};
+using KernelOps = Avx512Ops;
+constexpr const char* KERNEL_NAME = "avx512";
+#elif defined(__AVX2__)
+using KernelOps = Avx2Ops;
+constexpr const char* KERNEL_NAME = "avx2";
+#else
+using KernelOps = ScalarOps;
+constexpr const char* KERNEL_NAME = "scalar";
+#endif
+
+constexpr size_t COLUMN_ALIGNMENT = 64;
+constexpr size_t FACTOR_COUNT = 4;
+}
+
+// Factor field columns; every column holds `padded` doubles
+struct FactorPanel::Columns {
+    explicit Columns(size_t size)
+        : padded((size + COLUMN_ALIGNMENT / sizeof(double) - 1) / (COLUMN_ALIGNMENT / sizeof(double)) *
+                 (COLUMN_ALIGNMENT / sizeof(double))) {
+        for (double** column : all()) {
+            void* memory = std::aligned_alloc(COLUMN_ALIGNMENT, padded * sizeof(double));
+            if (!memory) {
+                throw std::bad_alloc();
+            }
+            std::memset(memory, 0, padded * sizeof(double));
+            *column = static_cast<double*>(memory);
+        }
+    }
+
+    ~Columns() {
+        for (double** column : all()) {
+            std::free(*column);
+        }
+    }
+
+    std::vector<double**> all() {
+        return {&bid, &ask, &prev_mid, &ema_fast, &ema_slow, &variance,
+                &last_return, &momentum, &volatility, &spread_bps, &score, &valid};
+    }
+
+    size_t padded;
+
+    // Latest quotes
+    double* bid{nullptr};
+    double* ask{nullptr};
+
+    // State carried between recomputes
+    double* prev_mid{nullptr};
+    double* ema_fast{nullptr};
+    double* ema_slow{nullptr};
+    double* variance{nullptr};
+
+    // Outputs of the last recompute
+    double* last_return{nullptr};
+    double* momentum{nullptr};
+    double* volatility{nullptr};
+    double* spread_bps{nullptr};
+    double* score{nullptr};
+    double* valid{nullptr};   // 1.0 when the instrument has a two-sided quote
+};
+
+namespace {
+struct FactorMoments {
+    double sum[FACTOR_COUNT];
+    double sum_squares[FACTOR_COUNT];
+    double count;
+};
+
+// Pass 1: advance per-instrument factor state and gather cross-sectional moments
+template <typename Ops>
+FactorMoments updateFactors(double* const* c, size_t padded, double fast_alpha, double slow_alpha, double variance_alpha) {
+    using Vec = typename Ops::Vec;
+    using Mask = typename Ops::Mask;
+
+    double* bid_col = c[0];
+    double* ask_col = c[1];
+    double* prev_col = c[2];
+    double* fast_col = c[3];
+    double* slow_col = c[4];
+    double* var_col = c[5];
+    double* ret_col = c[6];
+    double* mom_col = c[7];
+    double* vol_col = c[8];
+    double* spread_col = c[9];
+    double* valid_col = c[11];
+
+    const Vec zero = Ops::set1(0.0);
+    const Vec one = Ops::set1(1.0);
+    const Vec half = Ops::set1(0.5);
+    const Vec bps = Ops::set1(10000.0);
+    const Vec af = Ops::set1(fast_alpha);
+    const Vec as = Ops::set1(slow_alpha);
+    const Vec av = Ops::set1(variance_alpha);
+
+    Vec sum[FACTOR_COUNT];
+    Vec sum_squares[FACTOR_COUNT];
+    for (size_t f = 0; f < FACTOR_COUNT; ++f) {
+        sum[f] = zero;
+        sum_squares[f] = zero;
+    }
+    Vec count = zero;
+
+    for (size_t i = 0; i < padded; i += Ops::WIDTH) {
+        Vec bid = Ops::load(bid_col + i);
+        Vec ask = Ops::load(ask_col + i);
+        Vec prev = Ops::load(prev_col + i);
+
+        Vec mid = Ops::mul(half, Ops::add(bid, ask));
+        Mask valid = Ops::both(Ops::greater(bid, zero), Ops::greater(ask, zero));
+        Mask has_prev = Ops::both(valid, Ops::greater(prev, zero));
+
+        // Lanes without a previous mid divide by zero here; the result is discarded
+        Vec ret = Ops::select(has_prev, Ops::sub(Ops::div(mid, prev), one), zero);
+
+        Vec fast = Ops::load(fast_col + i);
+        Vec slow = Ops::load(slow_col + i);
+        fast = Ops::select(has_prev, Ops::add(fast, Ops::mul(af, Ops::sub(mid, fast))), Ops::select(valid, mid, fast));
+        slow = Ops::select(has_prev, Ops::add(slow, Ops::mul(as, Ops::sub(mid, slow))), Ops::select(valid, mid, slow));
+
+        Vec var = Ops::load(var_col + i);
+        var = Ops::select(has_prev, Ops::add(var, Ops::mul(av, Ops::sub(Ops::mul(ret, ret), var))), var);
+
+        Vec mom = Ops::select(valid, Ops::sub(Ops::div(fast, slow), one), zero);
+        Vec vol = Ops::sqrt(var);
+        Vec spread = Ops::select(valid, Ops::mul(Ops::div(Ops::sub(ask, bid), mid), bps), zero);
+
+        Ops::store(prev_col + i, Ops::select(valid, mid, prev));
+        Ops::store(fast_col + i, fast);
+        Ops::store(slow_col + i, slow);
+        Ops::store(var_col + i, var);
+        Ops::store(ret_col + i, ret);
+        Ops::store(mom_col + i, mom);
+        Ops::store(vol_col + i, vol);
+        Ops::store(spread_col + i, spread);
+        Ops::store(valid_col + i, Ops::select(valid, one, zero));
+
+        Vec factors[FACTOR_COUNT] = {ret, mom, Ops::select(valid, vol, zero), spread};
+        for (size_t f = 0; f < FACTOR_COUNT; ++f) {
+            sum[f] = Ops::add(sum[f], factors[f]);
+            sum_squares[f] = Ops::add(sum_squares[f], Ops::mul(factors[f], factors[f]));
+        }
+        count = Ops::add(count, Ops::select(valid, one, zero));
+    }
+
+    FactorMoments moments;
+    for (size_t f = 0; f < FACTOR_COUNT; ++f) {
+        moments.sum[f] = Ops::sum(sum[f]);
+        moments.sum_squares[f] = Ops::sum(sum_squares[f]);
+    }
+    moments.count = Ops::sum(count);
+    return moments;
+}
+
+// Pass 2: composite score from weighted cross-sectional z-scores
+template <typename Ops>
+void scoreFactors(double* const* c, size_t padded, const double* mean, const double* scale) {
+    using Vec = typename Ops::Vec;
+
+    const double* factor_cols[FACTOR_COUNT] = {c[6], c[7], c[8], c[9]};
+    double* score_col = c[10];
+    const double* valid_col = c[11];
+
+    Vec means[FACTOR_COUNT];
+    Vec scales[FACTOR_COUNT];
+    for (size_t f = 0; f < FACTOR_COUNT; ++f) {
+        means[f] = Ops::set1(mean[f]);
+        scales[f] = Ops::set1(scale[f]);
+    }
+    const Vec zero = Ops::set1(0.0);
+
+    for (size_t i = 0; i < padded; i += Ops::WIDTH) {
+        Vec score = zero;
+        for (size_t f = 0; f < FACTOR_COUNT; ++f) {
+            Vec value = Ops::load(factor_cols[f] + i);
+            score = Ops::add(score, Ops::mul(Ops::sub(value, means[f]), scales[f]));
+        }
+        Ops::store(score_col + i, Ops::select(Ops::greater(Ops::load(valid_col + i), zero), score, zero));
+    }
+}
+}
+
+FactorPanel::FactorPanel(const std::vector<InstrumentId>& universe)
+    : column_of_(ConfigManager::getInstance().max_instruments) {
+    config_ = ConfigManager::getInstance();
+
+    for (InstrumentId instrument_id : universe) {
+        uint32_t* column = column_of_.getOrCreate(instrument_id);
+        if (column && *column == 0) {
+            universe_.push_back(instrument_id);
+            *column = static_cast<uint32_t>(universe_.size());
+        }
+    }
+
+    columns_ = std::make_unique<Columns>(universe_.size());
+    rank_order_.reserve(universe_.size());
+    rank_scratch_.reserve(universe_.size());
+    snapshot_ = std::make_shared<const FactorSnapshot>(FactorSnapshot{0, 0, {}});
+}
+
+FactorPanel::~FactorPanel() = default;
+
+const char* FactorPanel::getKernelName() {
+    return KERNEL_NAME;
+}
+
+void FactorPanel::update(const Tick& tick) {
+    const uint32_t* column = column_of_.find(tick.instrument_id);
+    if (!column || *column == 0) {
+        return;
+    }
+
+    // Prices stay in ticks: every factor is a ratio, so the tick size cancels
+    columns_->bid[*column - 1] = tick.bid_price.count();
+    columns_->ask[*column - 1] = tick.ask_price.count();
+    dirty_ = true;
+}
+
+void FactorPanel::processTicks(const Tick* ticks, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        update(ticks[i]);
+    }
+
+    if (!dirty_) {
+        return;
+    }
+
+    if (config_.factor_recompute_interval_us <= 0) {
+        recompute();
+        return;
+    }
+
+    Timestamp now = Clock::now();
+    if (now - last_recompute_ >= static_cast<Timestamp>(config_.factor_recompute_interval_us) * 1000) {
+        recompute();
+    }
+}
+
+void FactorPanel::recompute() {
+    Columns& columns = *columns_;
+    double* column_ptrs[] = {columns.bid, columns.ask, columns.prev_mid, columns.ema_fast,
+                             columns.ema_slow, columns.variance, columns.last_return, columns.momentum,
+                             columns.volatility, columns.spread_bps, columns.score, columns.valid};
+
+    FactorMoments moments = updateFactors<KernelOps>(column_ptrs, columns.padded, config_.factor_fast_alpha,
+                                                     config_.factor_slow_alpha, config_.factor_variance_alpha);
+
+    // Fold the weights into the z-score scale: score = sum w * (x - mean) / sd
+    const double weights[FACTOR_COUNT] = {weights_.last_return, weights_.momentum,
+                                          weights_.volatility, weights_.spread};
+    double mean[FACTOR_COUNT];
+    double scale[FACTOR_COUNT];
+    for (size_t f = 0; f < FACTOR_COUNT; ++f) {
+        mean[f] = moments.count > 0 ? moments.sum[f] / moments.count : 0.0;
+        double variance = moments.count > 0 ? moments.sum_squares[f] / moments.count - mean[f] * mean[f] : 0.0;
+        double sd = variance > 0.0 ? std::sqrt(variance) : 0.0;
+        scale[f] = sd > 1e-12 ? weights[f] / sd : 0.0;
+    }
+
+    scoreFactors<KernelOps>(column_ptrs, columns.padded, mean, scale);
+
+    last_recompute_ = Clock::now();
+    dirty_ = false;
+    publish();
+}
+
+void FactorPanel::publish() {
+    const Columns& columns = *columns_;
+
+    // Map each score to an integer key that sorts best-first as unsigned
+    rank_order_.clear();
+    for (uint32_t i = 0; i < universe_.size(); ++i) {
+        if (columns.valid[i] > 0.0) {
+            double score = columns.score[i] + 0.0; // Fold -0.0 into +0.0
+            uint64_t bits;
+            std::memcpy(&bits, &score, sizeof(bits));
+            uint64_t ascending = (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+            rank_order_.push_back({~ascending, i});
+        }
+    }
+
+    // LSD radix sort, a byte per pass. Each pass is stable, so equal scores
+    // stay in column order, and passes where every key shares the byte are
+    // skipped. Comparison sorting was several times slower at universe sizes.
+    rank_scratch_.resize(rank_order_.size());
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        size_t counts[257] = {0};
+        for (const RankEntry& entry : rank_order_) {
+            counts[((entry.key >> shift) & 0xFF) + 1]++;
+        }
+        bool single_bucket = false;
+        for (size_t b = 1; b <= 256; ++b) {
+            if (counts[b] == rank_order_.size()) {
+                single_bucket = true;
+            }
+            counts[b] += counts[b - 1];
+        }
+        if (single_bucket) {
+            continue;
+        }
+        for (const RankEntry& entry : rank_order_) {
+            rank_scratch_[counts[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        rank_order_.swap(rank_scratch_);
+    }
+
+    auto snapshot = std::make_shared<FactorSnapshot>();
+    snapshot->sequence = ++recompute_count_;
+    snapshot->timestamp = last_recompute_;
+    snapshot->ranked.reserve(rank_order_.size());
+    for (const RankEntry& entry : rank_order_) {
+        uint32_t i = entry.column;
+        snapshot->ranked.push_back({universe_[i], columns.score[i], columns.last_return[i],
+                                    columns.momentum[i], columns.volatility[i], columns.spread_bps[i]});
+    }
+
+    std::atomic_store_explicit(&snapshot_, std::shared_ptr<const FactorSnapshot>(std::move(snapshot)),
+                               std::memory_order_release);
+}
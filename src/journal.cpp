@@ -0,0 +1,236 @@
+#include "../include/journal.h"
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+constexpr uint64_t JOURNAL_MAGIC = 0x4A524E4C54534451ULL; // "QDSTLNRJ"
+// Bumped whenever a record layout changes, so readers refuse segments whose
+// records they would misinterpret. 2: prices and quantities are integer
+// ticks and lots, and order records carry the originating strategy.
+constexpr uint32_t JOURNAL_VERSION = 2;
+
+bool fileExists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+}
+
+std::string journalSegmentPath(const std::string& path_prefix, size_t index) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06zu.journal", index);
+    return path_prefix + suffix;
+}
+
+JournalWriter::JournalWriter(const std::string& path_prefix, uint32_t record_size, size_t segment_size)
+    : path_prefix_(path_prefix),
+      record_size_(record_size),
+      segment_size_(segment_size < sizeof(JournalSegmentHeader) + record_size
+                        ? sizeof(JournalSegmentHeader) + record_size
+                        : segment_size),
+      records_per_segment_((segment_size_ - sizeof(JournalSegmentHeader)) / record_size) {}
+
+JournalWriter::~JournalWriter() {
+    close();
+}
+
+bool JournalWriter::open() {
+    if (isOpen()) {
+        return true;
+    }
+
+    // Never overwrite existing segments, continue after the last one
+    size_t index = 0;
+    while (fileExists(journalSegmentPath(path_prefix_, index))) {
+        ++index;
+    }
+
+    return openSegment(index);
+}
+
+bool JournalWriter::append(const void* record) {
+    if (!isOpen()) {
+        return false;
+    }
+
+    if (segment_records_ == records_per_segment_) {
+        size_t next = segment_index_ + 1;
+        closeSegment();
+        if (!openSegment(next)) {
+            return false;
+        }
+    }
+
+    char* slot = base_ + sizeof(JournalSegmentHeader) + segment_records_ * record_size_;
+    std::memcpy(slot, record, record_size_);
+    segment_records_++;
+    records_written_++;
+    return true;
+}
+
+void JournalWriter::publish() {
+    if (isOpen()) {
+        reinterpret_cast<JournalSegmentHeader*>(base_)->record_count = segment_records_;
+    }
+}
+
+bool JournalWriter::sync() {
+    if (!isOpen()) {
+        return false;
+    }
+
+    // Records first, then the header count that covers them, so the count
+    // on disk never claims records that are not
+    static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t used = sizeof(JournalSegmentHeader) + segment_records_ * record_size_;
+    size_t start = synced_bytes_ / page_size * page_size;
+    bool ok = start >= used || ::msync(base_ + start, used - start, MS_SYNC) == 0;
+    if (!ok) {
+        return false;
+    }
+
+    publish();
+    if (::msync(base_, page_size < used ? page_size : used, MS_SYNC) != 0) {
+        return false;
+    }
+    synced_bytes_ = used;
+    return true;
+}
+
+void JournalWriter::close() {
+    closeSegment();
+}
+
+bool JournalWriter::openSegment(size_t index) {
+    std::string path = journalSegmentPath(path_prefix_, index);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create journal segment " << path << std::endl;
+        return false;
+    }
+
+    // Reserve the whole segment up front so appends never extend the file
+    if (::posix_fallocate(fd, 0, static_cast<off_t>(segment_size_)) != 0 &&
+        ::ftruncate(fd, static_cast<off_t>(segment_size_)) != 0) {
+        std::cerr << "Failed to size journal segment " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* base = ::mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Failed to map journal segment " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    base_ = static_cast<char*>(base);
+    segment_index_ = index;
+    segment_records_ = 0;
+    synced_bytes_ = 0;
+    segments_created_++;
+
+    auto* header = reinterpret_cast<JournalSegmentHeader*>(base_);
+    std::memset(header, 0, sizeof(JournalSegmentHeader));
+    header->magic = JOURNAL_MAGIC;
+    header->version = JOURNAL_VERSION;
+    header->record_size = record_size_;
+    header->record_count = 0;
+    return true;
+}
+
+void JournalWriter::closeSegment() {
+    if (!isOpen()) {
+        return;
+    }
+
+    if (!sync()) {
+        std::cerr << "Failed to sync journal segment " << segment_index_ << std::endl;
+    }
+    size_t used = sizeof(JournalSegmentHeader) + segment_records_ * record_size_;
+    ::munmap(base_, segment_size_);
+
+    // Drop the unused tail of the pre-allocated segment
+    if (::ftruncate(fd_, static_cast<off_t>(used)) != 0) {
+        std::cerr << "Failed to trim journal segment " << segment_index_ << std::endl;
+    }
+    ::close(fd_);
+
+    fd_ = -1;
+    base_ = nullptr;
+}
+
+JournalReader::JournalReader(const std::string& path_prefix, uint32_t record_size)
+    : path_prefix_(path_prefix), record_size_(record_size) {}
+
+JournalReader::~JournalReader() {
+    close();
+}
+
+bool JournalReader::open() {
+    close();
+    incompatible_ = false;
+
+    for (size_t index = 0;; ++index) {
+        std::string path = journalSegmentPath(path_prefix_, index);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            break;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalSegmentHeader)) {
+            ::close(fd);
+            break;
+        }
+
+        size_t length = static_cast<size_t>(st.st_size);
+        void* base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            break;
+        }
+        ::madvise(base, length, MADV_SEQUENTIAL);
+
+        const auto* header = static_cast<const JournalSegmentHeader*>(base);
+        if (header->magic != JOURNAL_MAGIC || header->version != JOURNAL_VERSION ||
+            header->record_size != record_size_) {
+            std::cerr << "Journal segment " << path << " has an unexpected format (version "
+                      << header->version << ", expected " << JOURNAL_VERSION << ")" << std::endl;
+            ::munmap(base, length);
+            incompatible_ = true;
+            break;
+        }
+
+        // Never trust the count beyond what the file actually holds
+        uint64_t capacity = (length - sizeof(JournalSegmentHeader)) / record_size_;
+        uint64_t count = header->record_count < capacity ? header->record_count : capacity;
+
+        segments_.push_back({static_cast<char*>(base), length, count});
+        total_records_ += count;
+    }
+
+    return !segments_.empty();
+}
+
+void JournalReader::close() {
+    for (auto& segment : segments_) {
+        ::munmap(segment.base, segment.length);
+    }
+    segments_.clear();
+    total_records_ = 0;
+}
+
+const void* JournalReader::segmentRecords(size_t segment) const {
+    return segments_[segment].base + sizeof(JournalSegmentHeader);
+}
+
+uint64_t JournalReader::segmentRecordCount(size_t segment) const {
+    return segments_[segment].record_count;
+}
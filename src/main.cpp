@@ -4,6 +4,8 @@
 #include "../include/risk_management.h"
 #include "../include/strategy_engine.h"
 #include "../include/connectivity_layer.h"
+#include "../include/instrument_spec.h"
+#include "../include/clock.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -20,6 +22,11 @@ int main() {
     auto strategy_engine = std::make_unique<StrategyEngine>();
     auto connectivity_layer = std::make_unique<ConnectivityLayer>();
     
+    // Contract terms: prices and quantities are held as ticks and lots
+    InstrumentSpecs& specs = InstrumentSpecs::getInstance();
+    specs.setSpec(1, {0.01, 1.0});
+    specs.setSpec(2, {0.01, 1.0});
+    
     // Initialize risk limits
     RiskLimits limits;
     limits.max_position_size = 10000;
@@ -32,9 +39,9 @@ int main() {
     risk_management->initialize(limits);
     
     // Set up callbacks
-    auto tick_callback = [&](const Tick& tick) {
-        // Process tick through strategy engine
-        strategy_engine->processTick(tick);
+    auto tick_batch_callback = [&](const Tick* ticks, size_t count) {
+        // Process a batch of ticks through strategy engine
+        strategy_engine->processTicks(ticks, count);
     };
     
     auto order_callback = [&](const Order& order) {
@@ -59,7 +66,7 @@ int main() {
     };
     
     // Initialize components with callbacks
-    market_data_handler->initialize(tick_callback);
+    market_data_handler->initializeBatch(tick_batch_callback);
     order_management->initialize(order_callback);
     execution_management->initialize(order_callback);
     strategy_engine->initialize(signal_callback);
@@ -93,11 +100,12 @@ int main() {
         // Create a mock tick
         Tick tick;
         tick.instrument_id = 1;
-        tick.bid_price = 100.0 + i * 0.1;
-        tick.ask_price = 100.1 + i * 0.1;
-        tick.bid_size = 1000;
-        tick.ask_size = 1000;
-        tick.timestamp = std::chrono::high_resolution_clock::now();
+        tick.bid_price = specs.toPrice(1, 100.0 + i * 0.1);
+        tick.ask_price = specs.toPrice(1, 100.1 + i * 0.1);
+        tick.bid_size = specs.toQuantity(1, 1000);
+        tick.ask_size = specs.toQuantity(1, 1000);
+        tick.exchange_timestamp = Clock::now();
+        tick.receive_timestamp = 0; // Stamped by the handler
         
         // Add the tick to processing queue
         market_data_handler->addTick(tick);
@@ -107,9 +115,9 @@ int main() {
         order.instrument_id = 1;
         order.type = OrderType::LIMIT;
         order.side = OrderSide::BUY;
-        order.price = 100.0;
-        order.quantity = 100;
-        order.timestamp = std::chrono::high_resolution_clock::now();
+        order.price = specs.toPrice(1, 100.0);
+        order.quantity = specs.toQuantity(1, 100);
+        order.timestamp = Clock::now();
         order.market = Market::USA_NYSE;
         
         OrderId id = order_management->submitOrder(order);
@@ -0,0 +1,697 @@
+#include "../include/market_data_feed.h"
+#include "../include/clock.h"
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace {
+constexpr size_t RECEIVE_BATCH = 64;
+
+constexpr uint32_t PCAP_MAGIC_MICROS = 0xa1b2c3d4;
+constexpr uint32_t PCAP_MAGIC_NANOS = 0xa1b23c4d;
+constexpr size_t PCAP_GLOBAL_HEADER_SIZE = 24;
+constexpr size_t PCAP_RECORD_HEADER_SIZE = 16;
+constexpr uint32_t PCAP_LINKTYPE_ETHERNET = 1;
+
+inline uint16_t load16(const uint8_t* p) {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return __builtin_bswap16(value);
+}
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return __builtin_bswap32(value);
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return __builtin_bswap64(value);
+}
+
+inline void store16(uint8_t* p, uint16_t value) {
+    value = __builtin_bswap16(value);
+    std::memcpy(p, &value, sizeof(value));
+}
+
+inline void store32(uint8_t* p, uint32_t value) {
+    value = __builtin_bswap32(value);
+    std::memcpy(p, &value, sizeof(value));
+}
+
+inline void store64(uint8_t* p, uint64_t value) {
+    value = __builtin_bswap64(value);
+    std::memcpy(p, &value, sizeof(value));
+}
+
+inline uint32_t loadLE32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline Price decodePrice(const InstrumentSpec& spec, uint32_t raw) {
+    return spec.toPrice(raw / feed::PRICE_SCALE);
+}
+
+inline Quantity decodeQuantity(const InstrumentSpec& spec, uint32_t raw) {
+    return spec.toQuantity(raw);
+}
+
+inline uint32_t encodePrice(const InstrumentSpec& spec, Price price) {
+    return static_cast<uint32_t>(std::llround(spec.toDecimal(price) * feed::PRICE_SCALE));
+}
+
+inline uint32_t encodeQuantity(const InstrumentSpec& spec, Quantity quantity) {
+    return static_cast<uint32_t>(std::llround(spec.toDecimal(quantity)));
+}
+
+// Locate the UDP payload inside an Ethernet/IPv4 frame
+bool udpPayload(const uint8_t* frame, size_t length, const uint8_t*& payload, size_t& payload_length) {
+    size_t offset = 14;
+    if (length < offset) {
+        return false;
+    }
+
+    uint16_t ether_type = load16(frame + 12);
+    if (ether_type == 0x8100) { // 802.1Q tag
+        if (length < offset + 4) {
+            return false;
+        }
+        ether_type = load16(frame + 16);
+        offset += 4;
+    }
+    if (ether_type != 0x0800 || length < offset + 20) {
+        return false;
+    }
+
+    const uint8_t* ip = frame + offset;
+    size_t ip_header = (ip[0] & 0x0F) * 4;
+    if (ip[9] != 17 || length < offset + ip_header + 8) {
+        return false;
+    }
+
+    const uint8_t* udp = ip + ip_header;
+    size_t udp_length = load16(udp + 4);
+    if (udp_length < 8 || offset + ip_header + udp_length > length) {
+        return false;
+    }
+
+    payload = udp + 8;
+    payload_length = udp_length - 8;
+    return true;
+}
+}
+
+MarketDataFeed::MarketDataFeed(Market market, TickSink sink)
+    : market_(market), sink_(sink), specs_(InstrumentSpecs::getInstance()) {
+    config_ = ConfigManager::getInstance();
+    books_ = std::make_unique<InstrumentTable<std::unique_ptr<OrderBook>>>(config_.max_instruments);
+}
+
+MarketDataFeed::~MarketDataFeed() {
+    stop();
+
+    if (socket_fd_ >= 0) {
+        ::close(socket_fd_);
+    }
+    if (file_base_) {
+        ::munmap(const_cast<uint8_t*>(file_base_), file_length_);
+    }
+}
+
+bool MarketDataFeed::addInstrument(InstrumentId instrument_id, Price base_price, size_t price_levels,
+                                   size_t max_orders) {
+    auto* slot = books_->getOrCreate(instrument_id);
+    if (!slot || *slot) {
+        return false;
+    }
+
+    *slot = std::make_unique<OrderBook>(instrument_id, base_price, price_levels, max_orders);
+    (*slot)->setTickCallback([this](const Tick& tick) {
+        if (!sink_(tick)) {
+            ticks_rejected_++;
+        }
+    });
+    return true;
+}
+
+bool MarketDataFeed::openMulticast(const std::string& group, uint16_t port, const std::string& interface_address) {
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to create feed socket" << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    int receive_buffer = 16 * 1024 * 1024;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+
+    // Short timeout so the receiver thread notices stop()
+    timeval timeout{0, 10000};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Failed to bind feed socket to port " << port << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    ip_mreq membership{};
+    if (::inet_pton(AF_INET, group.c_str(), &membership.imr_multiaddr) != 1 ||
+        ::inet_pton(AF_INET, interface_address.c_str(), &membership.imr_interface) != 1 ||
+        ::setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+        std::cerr << "Failed to join multicast group " << group << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    receive_buffers_.assign(RECEIVE_BATCH * feed::MAX_PACKET_SIZE, 0);
+    socket_fd_ = fd;
+    std::cout << "Feed for market " << static_cast<int>(market_) << " joined " << group << ":" << port << std::endl;
+    return true;
+}
+
+bool MarketDataFeed::openFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open feed capture " << path << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < PCAP_GLOBAL_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t length = static_cast<size_t>(st.st_size);
+    void* base = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(base, length, MADV_SEQUENTIAL);
+
+    const auto* bytes = static_cast<const uint8_t*>(base);
+    uint32_t magic = loadLE32(bytes);
+    if ((magic != PCAP_MAGIC_MICROS && magic != PCAP_MAGIC_NANOS) ||
+        loadLE32(bytes + 20) != PCAP_LINKTYPE_ETHERNET) {
+        std::cerr << "Unsupported feed capture format " << path << std::endl;
+        ::munmap(base, length);
+        return false;
+    }
+
+    file_base_ = bytes;
+    file_length_ = length;
+    file_offset_ = PCAP_GLOBAL_HEADER_SIZE;
+    return true;
+}
+
+bool MarketDataFeed::open(const std::string& endpoint) {
+    const std::string udp_scheme = "udp://";
+    const std::string file_scheme = "file://";
+
+    if (endpoint.compare(0, file_scheme.size(), file_scheme) == 0) {
+        return openFile(endpoint.substr(file_scheme.size()));
+    }
+
+    if (endpoint.compare(0, udp_scheme.size(), udp_scheme) == 0) {
+        std::string rest = endpoint.substr(udp_scheme.size());
+        std::string interface_address = "0.0.0.0";
+
+        size_t at = rest.find('@');
+        if (at != std::string::npos) {
+            interface_address = rest.substr(at + 1);
+            rest = rest.substr(0, at);
+        }
+
+        size_t colon = rest.rfind(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        int port = std::atoi(rest.substr(colon + 1).c_str());
+        if (port <= 0 || port > 65535) {
+            return false;
+        }
+        return openMulticast(rest.substr(0, colon), static_cast<uint16_t>(port), interface_address);
+    }
+
+    return false;
+}
+
+void MarketDataFeed::start() {
+    if (running_.exchange(true)) {
+        return; // Already running
+    }
+
+    receiver_thread_ = std::make_unique<std::thread>(&MarketDataFeed::receiverThread, this);
+}
+
+void MarketDataFeed::stop() {
+    running_ = false;
+    if (receiver_thread_ && receiver_thread_->joinable()) {
+        receiver_thread_->join();
+    }
+}
+
+void MarketDataFeed::receiverThread() {
+    while (running_) {
+        if (socket_fd_ >= 0) {
+            // Blocks until at least one datagram or the socket timeout
+            pollSocket();
+        } else if (file_base_) {
+            if (pollFile() == 0) {
+                break; // Capture fully replayed
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+size_t MarketDataFeed::poll() {
+    if (socket_fd_ >= 0) {
+        return pollSocket();
+    }
+    if (file_base_) {
+        return pollFile();
+    }
+    return 0;
+}
+
+size_t MarketDataFeed::pollSocket() {
+    mmsghdr messages[RECEIVE_BATCH];
+    iovec vectors[RECEIVE_BATCH];
+
+    for (size_t i = 0; i < RECEIVE_BATCH; ++i) {
+        vectors[i].iov_base = receive_buffers_.data() + i * feed::MAX_PACKET_SIZE;
+        vectors[i].iov_len = feed::MAX_PACKET_SIZE;
+        std::memset(&messages[i].msg_hdr, 0, sizeof(msghdr));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Wait for the first datagram, then take whatever else is already queued
+    int received = ::recvmmsg(socket_fd_, messages, RECEIVE_BATCH, MSG_WAITFORONE, nullptr);
+    if (received <= 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < received; ++i) {
+        decodePacket(static_cast<const uint8_t*>(vectors[i].iov_base), messages[i].msg_len);
+    }
+    return static_cast<size_t>(received);
+}
+
+size_t MarketDataFeed::pollFile() {
+    size_t processed = 0;
+
+    while (processed < RECEIVE_BATCH && file_offset_ + PCAP_RECORD_HEADER_SIZE <= file_length_) {
+        const uint8_t* record = file_base_ + file_offset_;
+        uint32_t captured = loadLE32(record + 8);
+        if (file_offset_ + PCAP_RECORD_HEADER_SIZE + captured > file_length_) {
+            file_offset_ = file_length_; // Truncated capture
+            break;
+        }
+
+        const uint8_t* payload = nullptr;
+        size_t payload_length = 0;
+        if (udpPayload(record + PCAP_RECORD_HEADER_SIZE, captured, payload, payload_length)) {
+            decodePacket(payload, payload_length);
+        }
+
+        file_offset_ += PCAP_RECORD_HEADER_SIZE + captured;
+        ++processed;
+    }
+
+    return processed;
+}
+
+size_t MarketDataFeed::decodePacket(const uint8_t* data, size_t length) {
+    if (length < feed::PACKET_HEADER_SIZE) {
+        decode_errors_++;
+        return 0;
+    }
+
+    uint64_t sequence = load64(data + 10);
+    uint16_t count = load16(data + 18);
+    packets_received_++;
+
+    // Messages below the expected sequence were already applied, from an
+    // earlier packet or the other line of an A/B pair. A heartbeat (no
+    // messages) carries the next sequence and only reveals gaps.
+    uint64_t seen = 0;
+    if (expected_sequence_ != 0) {
+        if (sequence > expected_sequence_) {
+            sequence_gaps_++;
+        } else if (count > 0 && sequence + count <= expected_sequence_) {
+            duplicate_messages_ += count;
+            return 0;
+        } else if (count > 0) {
+            seen = expected_sequence_ - sequence;
+            duplicate_messages_ += seen;
+        }
+    }
+    if (sequence + count > expected_sequence_) {
+        expected_sequence_ = sequence + count;
+    }
+
+    const uint8_t* p = data + feed::PACKET_HEADER_SIZE;
+    const uint8_t* end = data + length;
+    size_t applied = 0;
+    Timestamp receive_timestamp = Clock::now();
+
+    for (uint16_t i = 0; i < count; ++i) {
+        if (end - p < 2) {
+            decode_errors_++;
+            break;
+        }
+        size_t message_length = load16(p);
+        p += 2;
+        if (message_length == 0 || static_cast<size_t>(end - p) < message_length) {
+            decode_errors_++;
+            break;
+        }
+
+        const uint8_t* m = p;
+        p += message_length;
+        if (i < seen) {
+            continue;
+        }
+
+        // Unknown message types are skipped, like any ITCH consumer would;
+        // known ones must be long enough for every field before any is read
+        size_t message_size = feed::messageSize(m[0]);
+        if (message_size == 0) {
+            ++applied;
+            continue;
+        }
+        if (message_length < message_size) {
+            decode_errors_++;
+            continue;
+        }
+
+        InstrumentId instrument_id = load32(m + 1);
+        Timestamp exchange_timestamp = load64(m + message_length - 8);
+        InstrumentSpec spec = specs_.getSpec(instrument_id);
+        bool ok = false;
+
+        switch (m[0]) {
+            case 'A': {
+                Price price = decodePrice(spec, load32(m + 18));
+                OrderBook* book = bookFor(instrument_id, price);
+                if (book) {
+                    book->setEventTimestamps(exchange_timestamp, receive_timestamp);
+                }
+                OrderSide side = (m[13] == 'S') ? OrderSide::SELL : OrderSide::BUY;
+                ok = book && book->addOrder(load64(m + 5), side, price, decodeQuantity(spec, load32(m + 14)));
+                break;
+            }
+
+            case 'E': {
+                OrderBook* book = bookFor(instrument_id, Price(0));
+                if (book) {
+                    book->setEventTimestamps(exchange_timestamp, receive_timestamp);
+                }
+                ok = book && book->reduceOrder(load64(m + 5), decodeQuantity(spec, load32(m + 13)));
+                break;
+            }
+
+            case 'X': {
+                OrderBook* book = bookFor(instrument_id, Price(0));
+                if (book) {
+                    book->setEventTimestamps(exchange_timestamp, receive_timestamp);
+                }
+                ok = book && book->reduceOrder(load64(m + 5), decodeQuantity(spec, load32(m + 13)));
+                break;
+            }
+
+            case 'D': {
+                OrderBook* book = bookFor(instrument_id, Price(0));
+                if (book) {
+                    book->setEventTimestamps(exchange_timestamp, receive_timestamp);
+                }
+                ok = book && book->deleteOrder(load64(m + 5));
+                break;
+            }
+
+            case 'U': {
+                Price price = decodePrice(spec, load32(m + 25));
+                OrderBook* book = bookFor(instrument_id, price);
+                if (book) {
+                    book->setEventTimestamps(exchange_timestamp, receive_timestamp);
+                }
+                ok = book && book->replaceOrder(load64(m + 5), load64(m + 13), price,
+                                               decodeQuantity(spec, load32(m + 21)));
+                break;
+            }
+
+            case 'Q': {
+                Tick tick;
+                tick.instrument_id = instrument_id;
+                tick.bid_price = decodePrice(spec, load32(m + 5));
+                tick.bid_size = decodeQuantity(spec, load32(m + 9));
+                tick.ask_price = decodePrice(spec, load32(m + 13));
+                tick.ask_size = decodeQuantity(spec, load32(m + 17));
+                tick.exchange_timestamp = exchange_timestamp;
+                tick.receive_timestamp = receive_timestamp;
+                if (!sink_(tick)) {
+                    ticks_rejected_++; // Well formed, refused downstream
+                }
+                ok = true;
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        if (ok) {
+            ++applied;
+        } else {
+            decode_errors_++;
+        }
+    }
+
+    messages_decoded_ += applied;
+    return applied;
+}
+
+const OrderBook* MarketDataFeed::getBook(InstrumentId instrument_id) const {
+    auto* slot = books_->find(instrument_id);
+    return slot ? slot->get() : nullptr;
+}
+
+OrderBook* MarketDataFeed::bookFor(InstrumentId instrument_id, Price reference_price) {
+    auto* slot = books_->getOrCreate(instrument_id);
+    if (!slot) {
+        return nullptr;
+    }
+
+    if (!*slot) {
+        if (reference_price.count() <= 0) {
+            return nullptr; // Book cannot be centred before its first priced message
+        }
+
+        // Centre the price window on the first price seen
+        int64_t half_window = static_cast<int64_t>(config_.feed_book_price_levels / 2);
+        int64_t base_price = std::max<int64_t>(0, reference_price.count() - half_window);
+        addInstrument(instrument_id, Price(static_cast<Price::Rep>(base_price)),
+                      config_.feed_book_price_levels, config_.feed_book_max_orders);
+    }
+    return slot->get();
+}
+
+FeedPacketBuilder::FeedPacketBuilder(const std::string& session)
+    : buffer_(feed::MAX_PACKET_SIZE, 0) {
+    std::memset(session_, ' ', sizeof(session_));
+    std::memcpy(session_, session.data(), std::min(session.size(), sizeof(session_)));
+    begin(1);
+}
+
+void FeedPacketBuilder::begin(uint64_t sequence) {
+    std::memcpy(buffer_.data(), session_, sizeof(session_));
+    store64(buffer_.data() + 10, sequence);
+    store16(buffer_.data() + 18, 0);
+    size_ = feed::PACKET_HEADER_SIZE;
+    message_count_ = 0;
+}
+
+uint8_t* FeedPacketBuilder::reserve(size_t message_size) {
+    if (size_ + 2 + message_size > buffer_.size()) {
+        return nullptr; // Packet full, start a new one
+    }
+
+    uint8_t* p = buffer_.data() + size_;
+    store16(p, static_cast<uint16_t>(message_size));
+    size_ += 2 + message_size;
+    store16(buffer_.data() + 18, ++message_count_);
+    return p + 2;
+}
+
+bool FeedPacketBuilder::addOrder(InstrumentId instrument_id, uint64_t order_ref, OrderSide side,
+                                 Price price, Quantity quantity, Timestamp timestamp_ns) {
+    uint8_t* m = reserve(feed::ADD_ORDER_SIZE);
+    if (!m) {
+        return false;
+    }
+    InstrumentSpec spec = InstrumentSpecs::getInstance().getSpec(instrument_id);
+    m[0] = 'A';
+    store32(m + 1, static_cast<uint32_t>(instrument_id));
+    store64(m + 5, order_ref);
+    m[13] = (side == OrderSide::BUY) ? 'B' : 'S';
+    store32(m + 14, encodeQuantity(spec, quantity));
+    store32(m + 18, encodePrice(spec, price));
+    store64(m + 22, timestamp_ns);
+    return true;
+}
+
+bool FeedPacketBuilder::orderExecuted(InstrumentId instrument_id, uint64_t order_ref, Quantity quantity,
+                                      Timestamp timestamp_ns) {
+    uint8_t* m = reserve(feed::ORDER_EXECUTED_SIZE);
+    if (!m) {
+        return false;
+    }
+    m[0] = 'E';
+    store32(m + 1, static_cast<uint32_t>(instrument_id));
+    store64(m + 5, order_ref);
+    store32(m + 13, encodeQuantity(InstrumentSpecs::getInstance().getSpec(instrument_id), quantity));
+    store64(m + 17, timestamp_ns);
+    return true;
+}
+
+bool FeedPacketBuilder::orderCancel(InstrumentId instrument_id, uint64_t order_ref, Quantity quantity,
+                                    Timestamp timestamp_ns) {
+    uint8_t* m = reserve(feed::ORDER_CANCEL_SIZE);
+    if (!m) {
+        return false;
+    }
+    m[0] = 'X';
+    store32(m + 1, static_cast<uint32_t>(instrument_id));
+    store64(m + 5, order_ref);
+    store32(m + 13, encodeQuantity(InstrumentSpecs::getInstance().getSpec(instrument_id), quantity));
+    store64(m + 17, timestamp_ns);
+    return true;
+}
+
+bool FeedPacketBuilder::orderDelete(InstrumentId instrument_id, uint64_t order_ref, Timestamp timestamp_ns) {
+    uint8_t* m = reserve(feed::ORDER_DELETE_SIZE);
+    if (!m) {
+        return false;
+    }
+    m[0] = 'D';
+    store32(m + 1, static_cast<uint32_t>(instrument_id));
+    store64(m + 5, order_ref);
+    store64(m + 13, timestamp_ns);
+    return true;
+}
+
+bool FeedPacketBuilder::orderReplace(InstrumentId instrument_id, uint64_t order_ref, uint64_t new_order_ref,
+                                     Price price, Quantity quantity, Timestamp timestamp_ns) {
+    uint8_t* m = reserve(feed::ORDER_REPLACE_SIZE);
+    if (!m) {
+        return false;
+    }
+    InstrumentSpec spec = InstrumentSpecs::getInstance().getSpec(instrument_id);
+    m[0] = 'U';
+    store32(m + 1, static_cast<uint32_t>(instrument_id));
+    store64(m + 5, order_ref);
+    store64(m + 13, new_order_ref);
+    store32(m + 21, encodeQuantity(spec, quantity));
+    store32(m + 25, encodePrice(spec, price));
+    store64(m + 29, timestamp_ns);
+    return true;
+}
+
+bool FeedPacketBuilder::quote(const Tick& tick, Timestamp timestamp_ns) {
+    uint8_t* m = reserve(feed::QUOTE_SIZE);
+    if (!m) {
+        return false;
+    }
+    InstrumentSpec spec = InstrumentSpecs::getInstance().getSpec(tick.instrument_id);
+    m[0] = 'Q';
+    store32(m + 1, static_cast<uint32_t>(tick.instrument_id));
+    store32(m + 5, encodePrice(spec, tick.bid_price));
+    store32(m + 9, encodeQuantity(spec, tick.bid_size));
+    store32(m + 13, encodePrice(spec, tick.ask_price));
+    store32(m + 17, encodeQuantity(spec, tick.ask_size));
+    store64(m + 21, timestamp_ns);
+    return true;
+}
+
+PcapWriter::~PcapWriter() {
+    close();
+}
+
+bool PcapWriter::open(const std::string& path) {
+    close();
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+
+    // Nanosecond-resolution pcap, Ethernet link type
+    uint32_t header[6] = {PCAP_MAGIC_NANOS, 0x00040002, 0, 0, 65535, PCAP_LINKTYPE_ETHERNET};
+    return std::fwrite(header, sizeof(header), 1, file_) == 1;
+}
+
+bool PcapWriter::write(const uint8_t* payload, size_t length, Timestamp timestamp_ns, uint16_t port) {
+    if (!file_) {
+        return false;
+    }
+
+    uint8_t frame[14 + 20 + 8] = {};
+
+    // Ethernet: multicast destination MAC, IPv4 ethertype
+    frame[0] = 0x01; frame[1] = 0x00; frame[2] = 0x5e;
+    store16(frame + 12, 0x0800);
+
+    // IPv4 header without options or checksum
+    uint8_t* ip = frame + 14;
+    ip[0] = 0x45;
+    store16(ip + 2, static_cast<uint16_t>(20 + 8 + length));
+    ip[8] = 1;    // TTL
+    ip[9] = 17;   // UDP
+    store32(ip + 12, 0x7f000001);
+    store32(ip + 16, 0xef010101);
+
+    // UDP header without checksum
+    uint8_t* udp = ip + 20;
+    store16(udp, port);
+    store16(udp + 2, port);
+    store16(udp + 4, static_cast<uint16_t>(8 + length));
+
+    uint32_t captured = static_cast<uint32_t>(sizeof(frame) + length);
+    uint32_t record[4] = {static_cast<uint32_t>(timestamp_ns / 1000000000ULL),
+                          static_cast<uint32_t>(timestamp_ns % 1000000000ULL),
+                          captured, captured};
+
+    return std::fwrite(record, sizeof(record), 1, file_) == 1 &&
+           std::fwrite(frame, sizeof(frame), 1, file_) == 1 &&
+           std::fwrite(payload, length, 1, file_) == 1;
+}
+
+void PcapWriter::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
@@ -3,15 +3,35 @@
 #include <algorithm>
 
 MarketDataHandler::MarketDataHandler() {
-    tick_queue_ = std::make_unique<TickQueue>();
-    subscribed_instruments_ = std::make_unique<SubscribedInstruments>();
+    config_ = ConfigManager::getInstance();
+    
+    size_t shard_count = config_.market_data_sharded ? std::max<size_t>(1, config_.thread_pool_size) : 1;
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>(config_.queue_capacity,
+                                                  std::max<size_t>(1, config_.tick_batch_size),
+                                                  config_.market_data_wait_strategy,
+                                                  config_.spin_iterations));
+    }
+    
+    if (config_.market_data_conflation) {
+        // Each instrument sits in its shard's dirty queue at most once
+        conflation_slots_ = std::make_unique<InstrumentTable<ConflationSlot>>(config_.max_instruments);
+        for (auto& shard : shards_) {
+            shard->dirty_ = std::make_unique<BoundedRingBuffer<InstrumentId>>(config_.queue_capacity);
+        }
+    }
+    
+    subscribed_instruments_ = std::make_unique<SubscriptionFilter>(config_.max_instruments);
 }
 
 MarketDataHandler::~MarketDataHandler() {
     stop();
-    if (worker_thread_ && worker_thread_->joinable()) {
-        worker_thread_->join();
+    for (auto& shard : shards_) {
+        if (shard->worker_thread_ && shard->worker_thread_->joinable()) {
+            shard->worker_thread_->join();
+        }
     }
+    disableJournal();
 }
 
 bool MarketDataHandler::initialize(TickCallback callback) {
@@ -23,20 +43,64 @@ bool MarketDataHandler::initialize(TickCallback callback) {
     return true;
 }
 
+bool MarketDataHandler::initializeBatch(TickBatchCallback callback) {
+    if (!callback) {
+        return false;
+    }
+    
+    batch_callback_ = callback;
+    return true;
+}
+
 bool MarketDataHandler::connectToMarket(Market market, const std::string& endpoint) {
-    // In a real implementation, this would establish a connection to the market data feed
-    // For now, we'll just store the endpoint
+    if (endpoint.rfind("udp://", 0) == 0 || endpoint.rfind("file://", 0) == 0) {
+        auto feed = std::make_unique<MarketDataFeed>(market, [this](const Tick& tick) { return addTick(tick); });
+        if (!feed->open(endpoint)) {
+            std::cerr << "Failed to open feed for market " << static_cast<int>(market) << " at " << endpoint << std::endl;
+            return false;
+        }
+        
+        if (running_) {
+            feed->start();
+        }
+        market_feeds_[market] = std::move(feed);
+    }
+    
+    // Plain endpoints are only recorded, there is no feed behind them yet
     market_connections_[market] = endpoint;
     std::cout << "Connected to market " << static_cast<int>(market) << " at " << endpoint << std::endl;
     return true;
 }
 
+const MarketDataFeed* MarketDataHandler::getFeed(Market market) const {
+    auto it = market_feeds_.find(market);
+    return it != market_feeds_.end() ? it->second.get() : nullptr;
+}
+
 void MarketDataHandler::start() {
     if (running_.exchange(true)) {
         return; // Already running
     }
     
-    worker_thread_ = std::make_unique<std::thread>(&MarketDataHandler::workerThread, this);
+    std::cout << "Market data workers " << shards_.size() << ", queue capacity " << getQueueCapacity()
+              << ", overflow policy " << static_cast<int>(config_.tick_queue_overflow_policy) << std::endl;
+    
+    auto now = std::chrono::steady_clock::now();
+    for (auto& shard : shards_) {
+        // Join a worker left over from a previous start/stop cycle
+        if (shard->worker_thread_ && shard->worker_thread_->joinable()) {
+            shard->worker_thread_->join();
+        }
+        
+        shard->stopped_ = false;
+        shard->last_sample_ticks_ = shard->ticks_processed_;
+        shard->last_sample_time_ = now;
+        shard->worker_thread_ = std::make_unique<std::thread>(&MarketDataHandler::workerThread, this, shard.get());
+    }
+    
+    for (auto& feed : market_feeds_) {
+        feed.second->start();
+    }
 }
 
 void MarketDataHandler::stop() {
@@ -44,71 +108,330 @@ void MarketDataHandler::stop() {
         return; // Not running
     }
     
-    tick_queue_->stopped_ = true;
-    tick_queue_->cv_.notify_all();
+    for (auto& feed : market_feeds_) {
+        feed.second->stop();
+    }
+    
+    for (auto& shard : shards_) {
+        shard->stopped_ = true;
+        shard->waiter_.notify();
+    }
+}
+
+bool MarketDataHandler::enableJournal(const std::string& path_prefix) {
+    std::lock_guard<std::mutex> lock(journal_mutex_);
+    if (journal_.load(std::memory_order_relaxed)) {
+        return false; // Already capturing
+    }
+    
+    auto journal = std::make_unique<TickJournalWriter>(path_prefix, config_.tick_journal_segment_size,
+                                                       config_.queue_capacity);
+    if (!journal->start()) {
+        return false;
+    }
+    
+    journal_.store(journal.release(), std::memory_order_release);
+    std::cout << "Recording ticks to journal " << path_prefix << std::endl;
+    return true;
+}
+
+void MarketDataHandler::disableJournal() {
+    std::lock_guard<std::mutex> lock(journal_mutex_);
+    TickJournalWriter* journal = journal_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!journal) {
+        return;
+    }
+    
+    // Producers still inside recordTick() are one ring push from leaving;
+    // once they have, destroying the writer flushes and closes the journal
+    journal_reclaimer_.retireObject(journal);
+    while (journal_reclaimer_.reclaim() > 0) {
+        std::this_thread::yield();
+    }
 }
 
 bool MarketDataHandler::subscribe(InstrumentId instrument_id) {
-    std::lock_guard<std::mutex> lock(subscribed_instruments_->mutex_);
-    return subscribed_instruments_->set_.insert(instrument_id).second;
+    return subscribed_instruments_->add(instrument_id);
 }
 
 bool MarketDataHandler::unsubscribe(InstrumentId instrument_id) {
-    std::lock_guard<std::mutex> lock(subscribed_instruments_->mutex_);
-    return subscribed_instruments_->set_.erase(instrument_id) > 0;
+    return subscribed_instruments_->remove(instrument_id);
+}
+
+uint64_t MarketDataHandler::getTicksReceived() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->ticks_processed_.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t MarketDataHandler::getQueueDepth() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->dirty_ ? shard->dirty_->size() : shard->ring_.size();
+    }
+    return total;
+}
+
+uint64_t MarketDataHandler::getConflatedUpdates(InstrumentId instrument_id) const {
+    if (!conflation_slots_) {
+        return 0;
+    }
+    
+    const ConflationSlot* slot = conflation_slots_->find(instrument_id);
+    return slot ? slot->conflated_.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t MarketDataHandler::getTicksConflated() const {
+    if (!conflation_slots_) {
+        return 0;
+    }
+    
+    uint64_t total = 0;
+    conflation_slots_->forEach([&total](InstrumentId, const ConflationSlot& slot) {
+        total += slot.conflated_.load(std::memory_order_relaxed);
+    });
+    return total;
 }
 
-void MarketDataHandler::workerThread() {
+std::vector<ShardStats> MarketDataHandler::getShardStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    
+    auto now = std::chrono::steady_clock::now();
+    std::vector<ShardStats> stats;
+    stats.reserve(shards_.size());
+    
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        Shard& shard = *shards_[i];
+        uint64_t processed = shard.ticks_processed_.load(std::memory_order_relaxed);
+        double elapsed = std::chrono::duration<double>(now - shard.last_sample_time_).count();
+        double rate = elapsed > 0 ? (processed - shard.last_sample_ticks_) / elapsed : 0.0;
+        
+        size_t depth = shard.dirty_ ? shard.dirty_->size() : shard.ring_.size();
+        stats.push_back({i, depth, processed, rate});
+        
+        shard.last_sample_ticks_ = processed;
+        shard.last_sample_time_ = now;
+    }
+    
+    return stats;
+}
+
+void MarketDataHandler::workerThread(Shard* shard) {
+    const size_t max_batch = shard->batch_.size();
+    const auto latency_bound = std::chrono::microseconds(config_.tick_batch_latency_us);
+    
     while (running_) {
-        std::unique_lock<std::mutex> lock(tick_queue_->mutex_);
+        if (shard->dirty_) {
+            // Conflation mode: deliver the freshest tick of each dirty instrument
+            size_t count = drainConflated(*shard, max_batch);
+            if (count == 0) {
+                shard->waiter_.wait([shard] { return !shard->dirty_->empty() || shard->stopped_; });
+                continue;
+            }
+            shard->waiter_.reset();
+            processBatch(*shard, count);
+            continue;
+        }
         
-        // Wait for ticks or timeout
-        if (tick_queue_->cv_.wait_for(lock, std::chrono::milliseconds(10), 
-                                     [this] { return !tick_queue_->queue_.empty() || tick_queue_->stopped_; })) {
-            
-            if (tick_queue_->stopped_) {
-                break;
+        // Drain up to one batch worth of ticks
+        size_t count = 0;
+        while (count < max_batch && shard->ring_.tryPop(shard->batch_[count])) {
+            ++count;
+        }
+        
+        if (count == 0) {
+            // Queue is empty, idle according to the configured wait strategy
+            shard->waiter_.wait([shard] { return !shard->ring_.empty() || shard->stopped_; });
+            continue;
+        }
+        
+        // Optionally hold a partial batch for a bounded time to let it fill up
+        if (count < max_batch && batch_callback_ && latency_bound.count() > 0) {
+            Timestamp deadline = Clock::now() + static_cast<Timestamp>(latency_bound.count()) * 1000;
+            while (count < max_batch && running_) {
+                if (shard->ring_.tryPop(shard->batch_[count])) {
+                    ++count;
+                } else if (Clock::now() >= deadline) {
+                    break;
+                } else {
+                    cpuRelax();
+                }
             }
-            
-            // Process all available ticks
-            while (!tick_queue_->queue_.empty()) {
-                Tick tick = tick_queue_->queue_.front();
-                tick_queue_->queue_.pop();
-                lock.unlock();
-                
-                processTick(tick);
+        }
+        
+        shard->waiter_.reset();
+        processBatch(*shard, count);
+    }
+}
+
+size_t MarketDataHandler::drainConflated(Shard& shard, size_t max_count) {
+    size_t count = 0;
+    InstrumentId instrument_id;
+    
+    while (count < max_count && shard.dirty_->tryPop(instrument_id)) {
+        ConflationSlot* slot = conflation_slots_->find(instrument_id);
+        
+        // Clear the flag before reading so a newer update re-queues the instrument
+        slot->dirty_.store(false, std::memory_order_seq_cst);
+        uint64_t version;
+        Tick tick = slot->latest_.load(version);
+        
+        // An update landing between a producer's store and its flag exchange
+        // can queue the instrument twice for one tick; deliver each version once
+        if (version == slot->delivered_version_) {
+            continue;
+        }
+        if (version > slot->delivered_version_ + 1) {
+            // Versions in between were overwritten before we saw them
+            slot->conflated_.fetch_add(version - slot->delivered_version_ - 1, std::memory_order_relaxed);
+        }
+        slot->delivered_version_ = version;
+        shard.batch_[count++] = tick;
+    }
+    
+    return count;
+}
+
+bool MarketDataHandler::conflateTick(Shard& shard, const Tick& tick) {
+    ConflationSlot* slot = conflation_slots_->getOrCreate(tick.instrument_id);
+    if (!slot) {
+        ticks_rejected_++;
+        return false;
+    }
+    
+    slot->latest_.store(tick);
+    
+    // Already queued: the consumer will pick this update up instead of the
+    // one it has not seen yet, and count that one as conflated
+    if (!slot->dirty_.exchange(true, std::memory_order_seq_cst) && !shard.dirty_->tryPush(tick.instrument_id)) {
+        // More distinct instruments than the dirty queue holds
+        slot->dirty_.store(false, std::memory_order_relaxed);
+        ticks_rejected_++;
+        return false;
+    }
+    
+    shard.waiter_.notify();
+    return true;
+}
+
+bool MarketDataHandler::addTick(const Tick& tick) {
+    if (tick.receive_timestamp != 0) {
+        return addTick(tick, tick.receive_timestamp);
+    }
+    return addTick(tick, Clock::now());
+}
+
+bool MarketDataHandler::addTick(Tick tick, Timestamp receive_timestamp) {
+    tick.receive_timestamp = receive_timestamp;
+    return enqueueTick(tick, true);
+}
+
+bool MarketDataHandler::replayTick(const Tick& tick, Timestamp receive_timestamp) {
+    Tick replayed = tick;
+    replayed.receive_timestamp = receive_timestamp;
+    return enqueueTick(replayed, false);
+}
+
+bool MarketDataHandler::enqueueTick(const Tick& tick, bool record) {
+    Shard& shard = shardFor(tick.instrument_id);
+    
+    if (shard.dirty_) {
+        if (!conflateTick(shard, tick)) {
+            return false;
+        }
+        if (record) {
+            recordTick(tick);
+        }
+        return true;
+    }
+    
+    auto& ring = shard.ring_;
+    
+    if (!ring.tryPush(tick)) {
+        switch (config_.tick_queue_overflow_policy) {
+            case OverflowPolicy::REJECT:
+                ticks_rejected_++;
+                return false;
                 
-                lock.lock();
+            case OverflowPolicy::DROP_OLDEST: {
+                // Make room by discarding the oldest queued tick
+                Tick discarded;
+                while (!ring.tryPush(tick)) {
+                    if (ring.tryPop(discarded)) {
+                        ticks_dropped_++;
+                    }
+                }
+                break;
             }
+            
+            case OverflowPolicy::BLOCK:
+                // Wait for the worker to drain; give up if nobody is consuming
+                while (!ring.tryPush(tick)) {
+                    if (!running_ || shard.stopped_) {
+                        ticks_rejected_++;
+                        return false;
+                    }
+                    shard.waiter_.notify();
+                    std::this_thread::yield();
+                }
+                break;
         }
     }
+    
+    // Wake the worker thread if it is parked
+    shard.waiter_.notify();
+    
+    if (record) {
+        recordTick(tick);
+    }
+    return true;
 }
 
-void MarketDataHandler::addTick(const Tick& tick) {
-    // Add tick to the queue for processing
-    {
-        std::lock_guard<std::mutex> lock(tick_queue_->mutex_);
-        tick_queue_->queue_.push(tick);
+void MarketDataHandler::recordTick(const Tick& tick) {
+    if (!journal_.load(std::memory_order_relaxed)) {
+        return; // Capture is off, skip the guard
     }
     
-    // Notify the worker thread
-    tick_queue_->cv_.notify_one();
+    EpochReclaimer::Guard guard(journal_reclaimer_);
+    TickJournalWriter* journal = journal_.load(std::memory_order_acquire);
+    if (journal) {
+        journal->record(tick);
+    }
 }
 
-void MarketDataHandler::processTick(const Tick& tick) {
-    // Only process if instrument is subscribed
-    {
-        std::lock_guard<std::mutex> lock(subscribed_instruments_->mutex_);
-        if (subscribed_instruments_->set_.find(tick.instrument_id) == subscribed_instruments_->set_.end()) {
-            return;
+void MarketDataHandler::processBatch(Shard& shard, size_t count) {
+    Tick* ticks = shard.batch_.data();
+    
+    // Only keep subscribed instruments, compacting in place, and publish
+    // each kept tick to the process-wide last-value cache
+    LastValueCache& last_values = LastValueCache::getInstance();
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (subscribed_instruments_->contains(ticks[i].instrument_id)) {
+            last_values.update(ticks[i]);
+            if (kept != i) {
+                ticks[kept] = ticks[i];
+            }
+            ++kept;
         }
     }
     
-    // Update tick counter
-    ticks_received_++;
+    if (kept == 0) {
+        return;
+    }
     
-    // Call the registered callback
-    if (tick_callback_) {
-        tick_callback_(tick);
+    // Update tick counter (single writer per shard)
+    shard.ticks_processed_.store(shard.ticks_processed_.load(std::memory_order_relaxed) + kept,
+                                 std::memory_order_relaxed);
+    
+    // Call the registered callback, one dispatch per batch when possible
+    if (batch_callback_) {
+        batch_callback_(ticks, kept);
+    } else if (tick_callback_) {
+        for (size_t i = 0; i < kept; ++i) {
+            tick_callback_(ticks[i]);
+        }
     }
-}
\ No newline at end of file
+}
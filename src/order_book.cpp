@@ -0,0 +1,357 @@
+#include "../include/order_book.h"
+#include "../include/clock.h"
+#include <algorithm>
+
+namespace {
+// Fibonacci hashing spreads sequential exchange order references
+inline uint64_t hashOrderRef(uint64_t order_ref) {
+    return order_ref * 0x9E3779B97F4A7C15ULL;
+}
+}
+
+OrderBook::OrderBook(InstrumentId instrument_id, Price base_price, size_t price_levels, size_t max_orders)
+    : instrument_id_(instrument_id),
+      base_price_(base_price),
+      levels_(price_levels),
+      bids_(price_levels, BookLevel{Quantity(0), 0}),
+      asks_(price_levels, BookLevel{Quantity(0), 0}),
+      best_bid_(-1),
+      best_ask_(static_cast<int64_t>(price_levels)),
+      orders_(max_orders) {
+    // Keep the hash at most half full so probe sequences stay short
+    size_t hash_size = 1;
+    while (hash_size < max_orders * 2) {
+        hash_size <<= 1;
+    }
+    hash_.assign(hash_size, EMPTY);
+    hash_mask_ = hash_size - 1;
+
+    for (size_t i = 0; i < orders_.size(); ++i) {
+        orders_[i].next_free = (i + 1 < orders_.size()) ? static_cast<uint32_t>(i + 1) : EMPTY;
+    }
+    free_head_ = orders_.empty() ? EMPTY : 0;
+
+    last_top_.instrument_id = instrument_id_;
+}
+
+bool OrderBook::addOrder(uint64_t order_ref, OrderSide side, Price price, Quantity quantity) {
+    int64_t level = levelOf(price);
+    if (level < 0 || quantity.count() <= 0) {
+        updates_rejected_++;
+        return false;
+    }
+
+    uint32_t entry = allocateEntry();
+    if (entry == EMPTY) {
+        updates_rejected_++;
+        return false; // Order pool exhausted
+    }
+
+    orders_[entry].order_ref = order_ref;
+    orders_[entry].level = level;
+    orders_[entry].quantity = quantity;
+    orders_[entry].side = side;
+
+    if (!insertOrder(order_ref, entry)) {
+        releaseEntry(entry);
+        updates_rejected_++;
+        return false; // Duplicate reference
+    }
+
+    order_count_++;
+    adjustLevel(side, level, quantity, 1);
+    updates_applied_++;
+    publishIfTopChanged();
+    return true;
+}
+
+bool OrderBook::modifyOrder(uint64_t order_ref, Price new_price, Quantity new_quantity) {
+    if (new_quantity.count() <= 0) {
+        return deleteOrder(order_ref);
+    }
+
+    uint32_t slot = findSlot(order_ref);
+    int64_t new_level = levelOf(new_price);
+    if (slot == EMPTY || new_level < 0) {
+        updates_rejected_++;
+        return false;
+    }
+
+    OrderEntry& order = orders_[hash_[slot]];
+    adjustLevel(order.side, order.level, -order.quantity, -1);
+    adjustLevel(order.side, new_level, new_quantity, 1);
+    order.level = new_level;
+    order.quantity = new_quantity;
+
+    updates_applied_++;
+    publishIfTopChanged();
+    return true;
+}
+
+bool OrderBook::reduceOrder(uint64_t order_ref, Quantity quantity) {
+    uint32_t slot = findSlot(order_ref);
+    if (slot == EMPTY || quantity.count() <= 0) {
+        updates_rejected_++;
+        return false;
+    }
+
+    OrderEntry& order = orders_[hash_[slot]];
+    if (quantity >= order.quantity) {
+        return deleteOrder(order_ref);
+    }
+
+    order.quantity -= quantity;
+    adjustLevel(order.side, order.level, -quantity, 0);
+
+    updates_applied_++;
+    publishIfTopChanged();
+    return true;
+}
+
+bool OrderBook::replaceOrder(uint64_t order_ref, uint64_t new_order_ref, Price new_price, Quantity new_quantity) {
+    uint32_t slot = findSlot(order_ref);
+    int64_t new_level = levelOf(new_price);
+    if (slot == EMPTY || new_level < 0 || new_quantity.count() <= 0) {
+        updates_rejected_++;
+        return false;
+    }
+
+    // Re-key the pooled entry under the new reference; it loses queue priority
+    uint32_t entry = hash_[slot];
+    OrderEntry& order = orders_[entry];
+    adjustLevel(order.side, order.level, -order.quantity, -1);
+    eraseSlot(slot);
+
+    order.order_ref = new_order_ref;
+    order.level = new_level;
+    order.quantity = new_quantity;
+
+    if (!insertOrder(new_order_ref, entry)) {
+        releaseEntry(entry);
+        order_count_--;
+        updates_rejected_++;
+        publishIfTopChanged();
+        return false;
+    }
+
+    adjustLevel(order.side, new_level, new_quantity, 1);
+    updates_applied_++;
+    publishIfTopChanged();
+    return true;
+}
+
+bool OrderBook::deleteOrder(uint64_t order_ref) {
+    uint32_t slot = findSlot(order_ref);
+    if (slot == EMPTY) {
+        updates_rejected_++;
+        return false;
+    }
+
+    uint32_t entry = hash_[slot];
+    const OrderEntry& order = orders_[entry];
+    adjustLevel(order.side, order.level, -order.quantity, -1);
+
+    eraseSlot(slot);
+    releaseEntry(entry);
+    order_count_--;
+
+    updates_applied_++;
+    publishIfTopChanged();
+    return true;
+}
+
+bool OrderBook::setLevel(OrderSide side, Price price, Quantity quantity) {
+    int64_t level = levelOf(price);
+    if (level < 0) {
+        updates_rejected_++;
+        return false;
+    }
+
+    const BookLevel& current = (side == OrderSide::BUY) ? bids_[level] : asks_[level];
+    Quantity target = quantity.count() > 0 ? quantity : Quantity(0);
+    int32_t orders = (target.count() > 0 ? 1 : 0) - static_cast<int32_t>(current.order_count > 0 ? 1 : 0);
+    adjustLevel(side, level, target - current.quantity, orders);
+
+    updates_applied_++;
+    publishIfTopChanged();
+    return true;
+}
+
+void OrderBook::clear() {
+    std::fill(bids_.begin(), bids_.end(), BookLevel{Quantity(0), 0});
+    std::fill(asks_.begin(), asks_.end(), BookLevel{Quantity(0), 0});
+    best_bid_ = -1;
+    best_ask_ = static_cast<int64_t>(levels_);
+
+    std::fill(hash_.begin(), hash_.end(), EMPTY);
+    for (size_t i = 0; i < orders_.size(); ++i) {
+        orders_[i].next_free = (i + 1 < orders_.size()) ? static_cast<uint32_t>(i + 1) : EMPTY;
+    }
+    free_head_ = orders_.empty() ? EMPTY : 0;
+    order_count_ = 0;
+
+    publishIfTopChanged();
+}
+
+Tick OrderBook::toTick() const {
+    Tick tick{};
+    tick.instrument_id = instrument_id_;
+    if (hasBid()) {
+        tick.bid_price = priceAt(best_bid_);
+        tick.bid_size = bids_[best_bid_].quantity;
+    }
+    if (hasAsk()) {
+        tick.ask_price = priceAt(best_ask_);
+        tick.ask_size = asks_[best_ask_].quantity;
+    }
+    tick.exchange_timestamp = exchange_timestamp_;
+    tick.receive_timestamp = receive_timestamp_ ? receive_timestamp_ : Clock::now();
+    return tick;
+}
+
+size_t OrderBook::getDepth(OrderSide side, DepthLevel* out, size_t max_levels) const {
+    size_t count = 0;
+
+    if (side == OrderSide::BUY) {
+        for (int64_t level = best_bid_; level >= 0 && count < max_levels; --level) {
+            if (bids_[level].quantity.count() > 0) {
+                out[count++] = {priceAt(level), bids_[level].quantity, bids_[level].order_count};
+            }
+        }
+    } else {
+        for (int64_t level = best_ask_; level < static_cast<int64_t>(levels_) && count < max_levels; ++level) {
+            if (asks_[level].quantity.count() > 0) {
+                out[count++] = {priceAt(level), asks_[level].quantity, asks_[level].order_count};
+            }
+        }
+    }
+
+    return count;
+}
+
+int64_t OrderBook::levelOf(Price price) const {
+    int64_t level = static_cast<int64_t>(price.count()) - base_price_.count();
+    return (level >= 0 && level < static_cast<int64_t>(levels_)) ? level : -1;
+}
+
+void OrderBook::adjustLevel(OrderSide side, int64_t level, Quantity quantity, int32_t orders) {
+    if (side == OrderSide::BUY) {
+        BookLevel& book_level = bids_[level];
+        book_level.quantity += quantity;
+        book_level.order_count += orders;
+
+        if (book_level.quantity.count() > 0) {
+            if (level > best_bid_) {
+                best_bid_ = level;
+            }
+        } else {
+            book_level = {Quantity(0), 0};
+            if (level == best_bid_) {
+                // Walk down to the next populated bid
+                while (best_bid_ >= 0 && bids_[best_bid_].quantity.count() <= 0) {
+                    --best_bid_;
+                }
+            }
+        }
+    } else {
+        BookLevel& book_level = asks_[level];
+        book_level.quantity += quantity;
+        book_level.order_count += orders;
+
+        if (book_level.quantity.count() > 0) {
+            if (level < best_ask_) {
+                best_ask_ = level;
+            }
+        } else {
+            book_level = {Quantity(0), 0};
+            if (level == best_ask_) {
+                // Walk up to the next populated ask
+                while (best_ask_ < static_cast<int64_t>(levels_) && asks_[best_ask_].quantity.count() <= 0) {
+                    ++best_ask_;
+                }
+            }
+        }
+    }
+}
+
+uint32_t OrderBook::findSlot(uint64_t order_ref) const {
+    uint64_t slot = hashOrderRef(order_ref) & hash_mask_;
+    while (hash_[slot] != EMPTY) {
+        if (orders_[hash_[slot]].order_ref == order_ref) {
+            return static_cast<uint32_t>(slot);
+        }
+        slot = (slot + 1) & hash_mask_;
+    }
+    return EMPTY;
+}
+
+bool OrderBook::insertOrder(uint64_t order_ref, uint32_t entry) {
+    uint64_t slot = hashOrderRef(order_ref) & hash_mask_;
+    while (hash_[slot] != EMPTY) {
+        if (orders_[hash_[slot]].order_ref == order_ref) {
+            return false;
+        }
+        slot = (slot + 1) & hash_mask_;
+    }
+    hash_[slot] = entry;
+    return true;
+}
+
+void OrderBook::eraseSlot(uint32_t slot) {
+    // Backward-shift deletion keeps linear probe chains intact without tombstones
+    uint64_t hole = slot;
+    uint64_t next = slot;
+    hash_[hole] = EMPTY;
+
+    for (;;) {
+        next = (next + 1) & hash_mask_;
+        if (hash_[next] == EMPTY) {
+            return;
+        }
+
+        uint64_t home = hashOrderRef(orders_[hash_[next]].order_ref) & hash_mask_;
+        bool movable = (next > hole) ? (home <= hole || home > next)
+                                     : (home <= hole && home > next);
+        if (movable) {
+            hash_[hole] = hash_[next];
+            hash_[next] = EMPTY;
+            hole = next;
+        }
+    }
+}
+
+uint32_t OrderBook::allocateEntry() {
+    uint32_t entry = free_head_;
+    if (entry != EMPTY) {
+        free_head_ = orders_[entry].next_free;
+    }
+    return entry;
+}
+
+void OrderBook::releaseEntry(uint32_t entry) {
+    orders_[entry].next_free = free_head_;
+    free_head_ = entry;
+}
+
+void OrderBook::publishIfTopChanged() {
+    Price bid = hasBid() ? priceAt(best_bid_) : Price(0);
+    Price ask = hasAsk() ? priceAt(best_ask_) : Price(0);
+    Quantity bid_size = hasBid() ? bids_[best_bid_].quantity : Quantity(0);
+    Quantity ask_size = hasAsk() ? asks_[best_ask_].quantity : Quantity(0);
+
+    if (bid == last_top_.bid_price && ask == last_top_.ask_price &&
+        bid_size == last_top_.bid_size && ask_size == last_top_.ask_size) {
+        return;
+    }
+
+    last_top_.bid_price = bid;
+    last_top_.bid_size = bid_size;
+    last_top_.ask_price = ask;
+    last_top_.ask_size = ask_size;
+
+    if (tick_callback_) {
+        last_top_.exchange_timestamp = exchange_timestamp_;
+        last_top_.receive_timestamp = receive_timestamp_ ? receive_timestamp_ : Clock::now();
+        tick_callback_(last_top_);
+    }
+}
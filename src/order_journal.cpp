@@ -0,0 +1,146 @@
+#include "../include/order_journal.h"
+#include <iostream>
+
+OrderJournalWriter::OrderJournalWriter(const std::string& path_prefix, size_t segment_size, size_t queue_capacity,
+                                       std::chrono::microseconds sync_interval)
+    : journal_(path_prefix, sizeof(OrderJournalRecord), segment_size),
+      ring_(queue_capacity),
+      waiter_(WaitStrategy::SPIN_THEN_PARK, 1000),
+      sync_interval_(sync_interval) {}
+
+OrderJournalWriter::~OrderJournalWriter() {
+    stop();
+}
+
+bool OrderJournalWriter::start() {
+    if (running_) {
+        return true;
+    }
+
+    if (!journal_.open()) {
+        return false;
+    }
+
+    last_sync_ = std::chrono::steady_clock::now();
+    running_ = true;
+    writer_thread_ = std::make_unique<std::thread>(&OrderJournalWriter::writerThread, this);
+    return true;
+}
+
+void OrderJournalWriter::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    waiter_.notify();
+    if (writer_thread_ && writer_thread_->joinable()) {
+        writer_thread_->join();
+    }
+
+    // Anything queued after the writer exited
+    drain();
+    sync();
+    if (!failed_.load(std::memory_order_acquire)) {
+        flushed_.store(flush_requests_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+    journal_.close();
+}
+
+bool OrderJournalWriter::flush() {
+    if (!running_) {
+        return false;
+    }
+
+    uint64_t ticket = flush_requests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    waiter_.notify();
+    // stop() acknowledges every ticket and a failure ends the wait, so this
+    // cannot hang
+    while (flushed_.load(std::memory_order_acquire) < ticket && !failed_.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    return !failed_.load(std::memory_order_acquire);
+}
+
+void OrderJournalWriter::writerThread() {
+    while (running_) {
+        // Tickets taken before this point cover records already in the ring
+        uint64_t requested = flush_requests_.load(std::memory_order_acquire);
+        size_t written = drain();
+
+        auto now = std::chrono::steady_clock::now();
+        bool flush_requested = requested != flushed_.load(std::memory_order_relaxed);
+        if (unsynced_ > 0 && (flush_requested || now - last_sync_ >= sync_interval_)) {
+            sync();
+        }
+        if (flush_requested && !failed_.load(std::memory_order_relaxed)) {
+            flushed_.store(requested, std::memory_order_release);
+        }
+
+        if (written > 0) {
+            waiter_.reset();
+            continue;
+        }
+
+        // Park until more events, a flush, or the next commit falls due
+        auto park = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            unsynced_ > 0 ? sync_interval_ - (now - last_sync_) : std::chrono::milliseconds(10));
+        waiter_.wait([this] {
+            return !ring_.empty() || !running_ ||
+                   flush_requests_.load(std::memory_order_relaxed) != flushed_.load(std::memory_order_relaxed);
+        }, park);
+    }
+}
+
+size_t OrderJournalWriter::drain() {
+    OrderJournalRecord entry;
+    size_t written = 0;
+
+    while (ring_.tryPop(entry)) {
+        if (!journal_.append(&entry)) {
+            fail("append failed, event for order " + std::to_string(entry.order_id) + " lost");
+            continue;
+        }
+        ++written;
+    }
+
+    // Published to the header by the next sync, once the records are durable
+    if (written > 0) {
+        unsynced_ += written;
+        records_written_ += written;
+    }
+    return written;
+}
+
+void OrderJournalWriter::sync() {
+    if (!journal_.sync()) {
+        fail("sync failed");
+    }
+    unsynced_ = 0;
+    last_sync_ = std::chrono::steady_clock::now();
+    sync_count_++;
+}
+
+void OrderJournalWriter::fail(const std::string& reason) {
+    if (!failed_.exchange(true, std::memory_order_acq_rel)) {
+        std::cerr << "Order journal " << reason << "; the journal is no longer complete" << std::endl;
+    }
+}
+
+OrderJournalReader::OrderJournalReader(const std::string& path_prefix)
+    : journal_(path_prefix, sizeof(OrderJournalRecord)) {}
+
+Order orderFromJournalRecord(const OrderJournalRecord& record) {
+    Order order;
+    order.order_id = record.order_id;
+    order.instrument_id = record.instrument_id;
+    order.type = record.type;
+    order.side = record.side;
+    order.price = record.price;
+    order.quantity = record.quantity;
+    order.filled_quantity = record.filled_quantity;
+    order.state = record.state;
+    order.market = record.market;
+    order.strategy_id = record.strategy_id;
+    order.timestamp = record.timestamp;
+    return order;
+}
@@ -1,13 +1,19 @@
 #include "../include/order_management_system.h"
+#include "../include/clock.h"
 #include <iostream>
-#include <chrono>
+#include <unordered_map>
 
 OrderManagementSystem::OrderManagementSystem() {
     config_ = ConfigManager::getInstance();
+    orders_ = std::make_unique<OrderStore>(config_.oms_slab_capacity, config_.oms_archive_capacity,
+                                           config_.max_instruments);
 }
 
 OrderManagementSystem::~OrderManagementSystem() {
-    // Clean up resources
+    // Drains and syncs outstanding events
+    if (journal_) {
+        journal_->stop();
+    }
 }
 
 bool OrderManagementSystem::initialize(OrderCallback callback) {
@@ -15,27 +21,101 @@ bool OrderManagementSystem::initialize(OrderCallback callback) {
         return false;
     }
     
+    if (!config_.order_journal_path.empty() && !journal_) {
+        if (!recoverFromJournal(config_.order_journal_path)) {
+            return false;
+        }
+        journal_ = std::make_unique<OrderJournalWriter>(
+            config_.order_journal_path, config_.order_journal_segment_size, config_.order_journal_queue_capacity,
+            std::chrono::microseconds(config_.order_journal_sync_interval_us));
+        if (!journal_->start()) {
+            std::cerr << "Failed to open order journal " << config_.order_journal_path << std::endl;
+            journal_.reset();
+            return false;
+        }
+    }
+    
     order_callback_ = callback;
     return true;
 }
 
+bool OrderManagementSystem::recoverFromJournal(const std::string& path_prefix) {
+    OrderJournalReader reader(path_prefix);
+    bool opened = reader.open();
+    if (reader.isIncompatible()) {
+        // Replaying part of the history, or appending after a segment we
+        // cannot read, would lose orders
+        std::cerr << "Order journal " << path_prefix << " was written in an incompatible format" << std::endl;
+        return false;
+    }
+    if (!opened) {
+        return true; // Nothing journaled yet
+    }
+    
+    // Each record is the order as it stood after the event, so replaying
+    // them in order leaves every order in its last journaled state. With a
+    // smaller slab than when the journal was written, a live order can meet
+    // another live order in its slot; it is held back until the end of the
+    // replay, by which time the other order has usually finished.
+    uint64_t events = 0;
+    std::unordered_map<OrderId, Order> deferred;
+    reader.forEach([this, &events, &deferred](const OrderJournalRecord& record) {
+        Order order = orderFromJournalRecord(record);
+        auto pending = deferred.find(order.order_id);
+        if (pending != deferred.end() && !isTerminalState(order.state)) {
+            pending->second = order;
+        } else {
+            if (pending != deferred.end()) {
+                deferred.erase(pending);
+            }
+            if (!orders_->restore(order)) {
+                deferred.emplace(order.order_id, order);
+            }
+        }
+        if (record.event == OrderEventType::SUBMIT) {
+            orders_submitted_++;
+        } else if (record.event == OrderEventType::STATE && record.state == OrderState::FILLED) {
+            orders_filled_++;
+        }
+        ++events;
+        return true;
+    });
+    
+    for (const auto& entry : deferred) {
+        if (!orders_->restore(entry.second)) {
+            std::cerr << "Live order " << entry.first << " collides with another live order; "
+                      << "oms_slab_capacity is smaller than when the journal was written" << std::endl;
+            return false;
+        }
+    }
+    
+    events_recovered_ = events;
+    std::cout << "Recovered " << events << " order events, " << orders_->getLiveCount()
+              << " live orders" << std::endl;
+    return true;
+}
+
+bool OrderManagementSystem::flushJournal() {
+    return journal_ && journal_->flush();
+}
+
 OrderId OrderManagementSystem::submitOrder(const Order& order) {
     if (!validateOrder(order)) {
         return 0; // Invalid order
     }
     
-    OrderId new_id = next_order_id_.fetch_add(1);
-    
-    // Create a copy of the order with the new ID
+    // Create a copy of the order, the store assigns its ID
     Order new_order = order;
-    new_order.order_id = new_id;
     new_order.state = OrderState::PENDING_NEW;
-    new_order.timestamp = std::chrono::high_resolution_clock::now();
+    new_order.timestamp = Clock::now();
     
     // Store the order
-    {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
-        orders_[new_id] = new_order;
+    OrderId new_id = orders_->create(new_order, [this](Order& stored) {
+        journal(OrderEventType::SUBMIT, stored);
+    }, new_order);
+    if (new_id == 0) {
+        std::cerr << "Order store full: " << orders_->getLiveCount() << " live orders" << std::endl;
+        return 0;
     }
     
     // Update counter
@@ -50,78 +130,125 @@ OrderId OrderManagementSystem::submitOrder(const Order& order) {
 }
 
 bool OrderManagementSystem::cancelOrder(OrderId order_id) {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    Order updated;
+    Timestamp now = Clock::now();
     
-    auto it = orders_.find(order_id);
-    if (it == orders_.end()) {
-        return false; // Order doesn't exist
-    }
-    
-    // Only allow cancellation if order is not already filled or cancelled
-    if (it->second.state == OrderState::FILLED || 
-        it->second.state == OrderState::CANCELLED || 
-        it->second.state == OrderState::REJECTED) {
+    // Fails for unknown orders, terminal orders and cancels already pending
+    auto cancel = [this, now](Order& order) {
+        order.timestamp = now;
+        journal(OrderEventType::CANCEL, order);
+    };
+    if (!orders_->transition(order_id, OrderState::PENDING_CANCEL, cancel, updated)) {
         return false;
     }
     
-    // Update state
-    it->second.state = OrderState::PENDING_CANCEL;
-    it->second.timestamp = std::chrono::high_resolution_clock::now();
-    
     // Call the callback
     if (order_callback_) {
-        order_callback_(it->second);
+        order_callback_(updated);
     }
     
     return true;
 }
 
+size_t OrderManagementSystem::cancelAll(const OrderFilter& filter) {
+    std::vector<OrderId> order_ids;
+    if (orders_->findLive(filter, order_ids) == 0) {
+        return 0;
+    }
+    
+    // The whole batch carries one timestamp
+    Timestamp now = Clock::now();
+    auto cancel = [this, now](Order& order) {
+        order.timestamp = now;
+        journal(OrderEventType::CANCEL, order);
+    };
+    
+    // Orders that filled or were cancelled since the lookup just fail
+    std::vector<Order> cancelled;
+    cancelled.reserve(order_ids.size());
+    Order updated;
+    for (OrderId order_id : order_ids) {
+        if (orders_->transition(order_id, OrderState::PENDING_CANCEL, cancel, updated)) {
+            cancelled.push_back(updated);
+        }
+    }
+    
+    // Emit the batch
+    if (batch_callback_) {
+        if (!cancelled.empty()) {
+            batch_callback_(cancelled.data(), cancelled.size());
+        }
+    } else if (order_callback_) {
+        for (const auto& order : cancelled) {
+            order_callback_(order);
+        }
+    }
+    
+    return cancelled.size();
+}
+
 bool OrderManagementSystem::modifyOrder(OrderId order_id, const Order& new_order) {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    Order updated;
+    Timestamp now = Clock::now();
     
-    auto it = orders_.find(order_id);
-    if (it == orders_.end()) {
-        return false; // Order doesn't exist
+    // Only live orders that are not being cancelled can be modified
+    auto modify = [this, &new_order, now](Order& order) {
+        order.type = new_order.type;
+        order.price = new_order.price;
+        order.quantity = new_order.quantity;
+        order.timestamp = now;
+        journal(OrderEventType::MODIFY, order);
+    };
+    if (!orders_->amend(order_id, modify, updated)) {
+        return false;
     }
     
-    // Only allow modification if order is not filled or cancelled
-    if (it->second.state == OrderState::FILLED || 
-        it->second.state == OrderState::CANCELLED || 
-        it->second.state == OrderState::REJECTED) {
+    // Call the callback
+    if (order_callback_) {
+        order_callback_(updated);
+    }
+    
+    return true;
+}
+
+bool OrderManagementSystem::updateOrderState(OrderId order_id, OrderState new_state) {
+    Order updated;
+    Timestamp now = Clock::now();
+    
+    auto update = [this, now](Order& order) {
+        order.timestamp = now;
+        journal(OrderEventType::STATE, order);
+    };
+    if (!orders_->transition(order_id, new_state, update, updated)) {
         return false;
     }
     
-    // Update order details
-    it->second.type = new_order.type;
-    it->second.price = new_order.price;
-    it->second.quantity = new_order.quantity;
-    it->second.timestamp = std::chrono::high_resolution_clock::now();
+    // Update counters if order is filled
+    if (new_state == OrderState::FILLED) {
+        orders_filled_++;
+    }
     
     // Call the callback
     if (order_callback_) {
-        order_callback_(it->second);
+        order_callback_(updated);
     }
     
     return true;
 }
 
 OrderState OrderManagementSystem::getOrderStatus(OrderId order_id) const {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
-    
-    auto it = orders_.find(order_id);
-    if (it != orders_.end()) {
-        return it->second.state;
+    Order order;
+    if (orders_->get(order_id, order)) {
+        return order.state;
     }
     
     return OrderState::REJECTED; // Order doesn't exist
 }
 
 Order OrderManagementSystem::getOrder(OrderId order_id) const {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
-    
-    auto it = orders_.find(order_id);
-    if (it != orders_.end()) {
-        return it->second;
+    Order order;
+    if (orders_->get(order_id, order)) {
+        return order;
     }
     
     // Return invalid order if not found
@@ -130,44 +257,34 @@ Order OrderManagementSystem::getOrder(OrderId order_id) const {
     invalid_order.instrument_id = 0;
     invalid_order.type = OrderType::LIMIT;
     invalid_order.side = OrderSide::BUY;
-    invalid_order.price = 0.0;
-    invalid_order.quantity = 0.0;
-    invalid_order.filled_quantity = 0.0;
+    invalid_order.price = Price(0);
+    invalid_order.quantity = Quantity(0);
+    invalid_order.filled_quantity = Quantity(0);
     invalid_order.state = OrderState::REJECTED;
     invalid_order.market = Market::UNKNOWN;
     return invalid_order; // Default constructed invalid order
 }
 
+size_t OrderManagementSystem::getLiveOrderCount() const {
+    return orders_->getLiveCount();
+}
+
+std::vector<OrderId> OrderManagementSystem::getLiveOrders(const OrderFilter& filter) const {
+    std::vector<OrderId> order_ids;
+    orders_->findLive(filter, order_ids);
+    return order_ids;
+}
+
 bool OrderManagementSystem::validateOrder(const Order& order) {
     // Basic validation checks
     if (order.instrument_id == 0) {
         return false;
     }
     
-    if (order.quantity <= 0 || order.price <= 0) {
+    if (order.quantity.count() <= 0 || order.price.count() <= 0) {
         return false;
     }
     
     // Additional validations can be added here
     return true;
 }
-
-void OrderManagementSystem::updateOrderState(OrderId order_id, OrderState new_state) {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
-    
-    auto it = orders_.find(order_id);
-    if (it != orders_.end()) {
-        it->second.state = new_state;
-        it->second.timestamp = std::chrono::high_resolution_clock::now();
-        
-        // Update counters if order is filled
-        if (new_state == OrderState::FILLED) {
-            orders_filled_++;
-        }
-        
-        // Call the callback
-        if (order_callback_) {
-            order_callback_(it->second);
-        }
-    }
-}
\ No newline at end of file
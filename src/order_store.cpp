@@ -0,0 +1,292 @@
+#include "../include/order_store.h"
+#include <algorithm>
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+// Row: from state, column: to state, both in OrderState order
+const bool VALID_TRANSITIONS[8][8] = {
+    //              PNEW   NEW    PFILL  FILLED PCANC  CANC   REJ    EXP
+    /* PENDING_NEW */ {true,  true,  true,  true,  true,  true,  true,  true},
+    /* NEW         */ {false, true,  true,  true,  true,  true,  false, true},
+    /* PART_FILLED */ {false, false, true,  true,  true,  true,  false, true},
+    /* FILLED      */ {false, false, false, false, false, false, false, false},
+    // A cancel can be rejected, or lose the race with a fill
+    /* PEND_CANCEL */ {false, true,  true,  true,  false, true,  false, true},
+    /* CANCELLED   */ {false, false, false, false, false, false, false, false},
+    /* REJECTED    */ {false, false, false, false, false, false, false, false},
+    /* EXPIRED     */ {false, false, false, false, false, false, false, false},
+};
+
+} // namespace
+
+bool isValidTransition(OrderState from, OrderState to) {
+    size_t row = static_cast<size_t>(from);
+    size_t column = static_cast<size_t>(to);
+    return row < 8 && column < 8 && VALID_TRANSITIONS[row][column];
+}
+
+OrderStore::OrderStore(size_t slab_capacity, size_t archive_capacity, size_t max_instruments)
+    : slab_mask_(roundUpToPowerOfTwo(slab_capacity) - 1),
+      archive_mask_(roundUpToPowerOfTwo(std::max(archive_capacity, slab_capacity)) - 1),
+      by_instrument_(max_instruments),
+      by_strategy_(MAX_INDEXED_STRATEGIES) {
+    slab_.reset(new Slot[slab_mask_ + 1]);
+    archive_.reset(new Seqlock<ArchivedOrder>[archive_mask_ + 1]);
+}
+
+OrderStore::~OrderStore() = default;
+
+OrderStore::Slot* OrderStore::claim(uint64_t& word) {
+    // Each failed probe consumes an id, so give up after one lap of the slab
+    for (size_t probe = 0; probe <= slab_mask_; ++probe) {
+        OrderId order_id = next_id_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slab_[order_id & slab_mask_];
+
+        word = slot.word.load(std::memory_order_acquire);
+        while (!isBusy(word) && slot.order_id.load(std::memory_order_relaxed) == 0) {
+            if (slot.word.compare_exchange_weak(word, word + SEQUENCE_ONE, std::memory_order_acquire)) {
+                std::atomic_thread_fence(std::memory_order_release);
+                slot.order_id.store(order_id, std::memory_order_relaxed);
+                return &slot;
+            }
+        }
+        ids_skipped_.fetch_add(1, std::memory_order_relaxed); // Held by a long-lived order
+    }
+    return nullptr;
+}
+
+bool OrderStore::restore(const Order& order) {
+    if (order.order_id == 0) {
+        return true; // Nothing to restore
+    }
+
+    Slot& slot = slab_[order.order_id & slab_mask_];
+    OrderId occupant = slot.order_id.load(std::memory_order_relaxed);
+    if (occupant != 0 && occupant != order.order_id) {
+        // Another live order holds the slot. A terminal order only needs
+        // its archive record; a live one has nowhere to go.
+        if (!isTerminalState(order.state)) {
+            return false;
+        }
+        archive(order);
+    } else {
+        uint64_t word = slot.word.load(std::memory_order_relaxed);
+        if (occupant != 0) {
+            unlink(slot); // Replaces an earlier image of the same order
+        }
+        slot.order = order;
+        slot.order_id.store(order.order_id, std::memory_order_relaxed);
+        if (isTerminalState(order.state)) {
+            retire(slot);
+        } else {
+            link(slot);
+        }
+        uint64_t sequence = (word & ~STATE_MASK) + 2 * SEQUENCE_ONE;
+        slot.word.store(sequence | static_cast<uint64_t>(order.state), std::memory_order_release);
+    }
+
+    if (order.order_id >= next_id_.load(std::memory_order_relaxed)) {
+        next_id_.store(order.order_id + 1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void OrderStore::retire(Slot& slot) {
+    // Archived before the slot is freed, so readers always find it in one.
+    // Ids sharing an archive record also share a slot, whose owner we are,
+    // so there is never a second writer.
+    archive(slot.order);
+
+    slot.order_id.store(0, std::memory_order_relaxed);
+    slot.order.order_id = 0;
+}
+
+void OrderStore::archive(const Order& order) {
+    ArchivedOrder record;
+    record.order_id = order.order_id;
+    record.instrument_id = order.instrument_id;
+    record.price = order.price;
+    record.quantity = order.quantity;
+    record.filled_quantity = order.filled_quantity;
+    record.timestamp = order.timestamp;
+    record.type = order.type;
+    record.side = order.side;
+    record.state = order.state;
+    record.market = order.market;
+    record.strategy_id = order.strategy_id;
+    archive_[order.order_id & archive_mask_].storeExclusive(record);
+}
+
+OrderStore::IndexList* OrderStore::listFor(Index index, const Slot& slot, bool create) const {
+    const Order& order = slot.order;
+    size_t shard = slotIndex(slot) % INDEX_SHARDS;
+    switch (index) {
+        case BY_INSTRUMENT:
+            return create ? by_instrument_.getOrCreate(order.instrument_id) : by_instrument_.find(order.instrument_id);
+        case BY_MARKET: {
+            size_t market = static_cast<size_t>(order.market);
+            return &by_market_[market < MARKET_COUNT ? market : 0][shard];
+        }
+        case BY_SIDE:
+            return &by_side_[order.side == OrderSide::SELL ? 1 : 0][shard];
+        case BY_STRATEGY:
+            return create ? by_strategy_.getOrCreate(order.strategy_id) : by_strategy_.find(order.strategy_id);
+        default:
+            return nullptr;
+    }
+}
+
+void OrderStore::link(Slot& slot) {
+    uint32_t self = slotIndex(slot);
+    for (size_t i = 0; i < INDEX_COUNT; ++i) {
+        Index index = static_cast<Index>(i);
+        IndexList* list = listFor(index, slot, true);
+        if (!list) {
+            slot.next[index] = slot.prev[index] = NO_SLOT;
+            continue;
+        }
+
+        list->lock();
+        slot.next[index] = list->head;
+        slot.prev[index] = NO_SLOT;
+        if (list->head != NO_SLOT) {
+            slab_[list->head].prev[index] = self;
+        }
+        list->head = self;
+        list->unlock();
+    }
+}
+
+void OrderStore::unlink(Slot& slot) {
+    for (size_t i = 0; i < INDEX_COUNT; ++i) {
+        Index index = static_cast<Index>(i);
+        IndexList* list = listFor(index, slot, false);
+        if (!list) {
+            continue;
+        }
+
+        list->lock();
+        uint32_t next = slot.next[index];
+        uint32_t prev = slot.prev[index];
+        if (prev != NO_SLOT) {
+            slab_[prev].next[index] = next;
+        } else {
+            list->head = next;
+        }
+        if (next != NO_SLOT) {
+            slab_[next].prev[index] = prev;
+        }
+        list->unlock();
+    }
+}
+
+size_t OrderStore::collect(IndexList& list, Index index, const OrderFilter& filter,
+                           std::vector<OrderId>& order_ids) const {
+    size_t found = 0;
+    list.lock();
+    // Indexed fields of a linked order do not change, and anything linked is
+    // live, so members can be read in place
+    for (uint32_t i = list.head; i != NO_SLOT; i = slab_[i].next[index]) {
+        const Slot& slot = slab_[i];
+        if (filter.matches(slot.order)) {
+            order_ids.push_back(slot.order_id.load(std::memory_order_relaxed));
+            found++;
+        }
+    }
+    list.unlock();
+    return found;
+}
+
+size_t OrderStore::findLive(const OrderFilter& filter, std::vector<OrderId>& order_ids) const {
+    // One list when the filter names a key the indexes cover
+    if (filter.by_strategy && filter.strategy_id < MAX_INDEXED_STRATEGIES) {
+        IndexList* list = by_strategy_.find(filter.strategy_id);
+        return list ? collect(*list, BY_STRATEGY, filter, order_ids) : 0;
+    }
+    if (filter.by_instrument && filter.instrument_id < by_instrument_.maxInstruments()) {
+        IndexList* list = by_instrument_.find(filter.instrument_id);
+        return list ? collect(*list, BY_INSTRUMENT, filter, order_ids) : 0;
+    }
+
+    // Otherwise the shards of one market, one side, or every market
+    size_t found = 0;
+    if (filter.by_market) {
+        size_t market = static_cast<size_t>(filter.market);
+        for (auto& shard : by_market_[market < MARKET_COUNT ? market : 0]) {
+            found += collect(shard, BY_MARKET, filter, order_ids);
+        }
+    } else if (filter.by_side) {
+        for (auto& shard : by_side_[filter.side == OrderSide::SELL ? 1 : 0]) {
+            found += collect(shard, BY_SIDE, filter, order_ids);
+        }
+    } else {
+        for (auto& market : by_market_) {
+            for (auto& shard : market) {
+                found += collect(shard, BY_MARKET, filter, order_ids);
+            }
+        }
+    }
+    return found;
+}
+
+size_t OrderStore::getLiveCount() const {
+    size_t live = 0;
+    for (size_t i = 0; i <= slab_mask_; ++i) {
+        if (slab_[i].order_id.load(std::memory_order_relaxed) != 0) {
+            live++;
+        }
+    }
+    return live;
+}
+
+bool OrderStore::get(OrderId order_id, Order& order) const {
+    if (order_id == 0) {
+        return false;
+    }
+
+    const Slot& slot = slab_[order_id & slab_mask_];
+    for (;;) {
+        uint64_t before = slot.word.load(std::memory_order_acquire);
+        if (isBusy(before)) {
+            cpuRelax();
+            continue;
+        }
+        bool live = slot.order_id.load(std::memory_order_relaxed) == order_id;
+        if (live) {
+            std::memcpy(&order, &slot.order, sizeof(Order));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.word.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        if (live) {
+            return true;
+        }
+        break;
+    }
+
+    ArchivedOrder record = archive_[order_id & archive_mask_].load();
+    if (record.order_id != order_id) {
+        return false;
+    }
+    order.order_id = record.order_id;
+    order.instrument_id = record.instrument_id;
+    order.type = record.type;
+    order.side = record.side;
+    order.price = record.price;
+    order.quantity = record.quantity;
+    order.filled_quantity = record.filled_quantity;
+    order.state = record.state;
+    order.market = record.market;
+    order.strategy_id = record.strategy_id;
+    order.timestamp = record.timestamp;
+    return true;
+}
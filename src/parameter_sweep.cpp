@@ -0,0 +1,88 @@
+#include "../include/parameter_sweep.h"
+#include "../include/tick_journal.h"
+#include "../include/thread_pool.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+ParameterSweep::ParameterSweep(const Tick* ticks, size_t count, const BacktestConfig& config)
+    : config_(config) {
+    spans_.push_back({ticks, count});
+}
+
+ParameterSweep::ParameterSweep(const TickJournalReader& journal, const BacktestConfig& config)
+    : config_(config) {
+    for (size_t segment = 0; segment < journal.getSegmentCount(); ++segment) {
+        uint64_t count = 0;
+        const Tick* ticks = journal.segmentTicks(segment, count);
+        spans_.push_back({ticks, static_cast<size_t>(count)});
+    }
+}
+
+void ParameterSweep::addMeanReversionGrid(const std::vector<InstrumentId>& instruments,
+                                          const std::vector<double>& thresholds,
+                                          const std::vector<size_t>& window_sizes) {
+    for (double threshold : thresholds) {
+        for (size_t window_size : window_sizes) {
+            std::ostringstream label;
+            label << "mean_reversion threshold=" << threshold << " window=" << window_size;
+            addCase({label.str(), [instruments, threshold, window_size](BacktestEngine& engine) {
+                for (InstrumentId instrument_id : instruments) {
+                    engine.addStrategy(std::make_unique<SimpleMeanReversionStrategy>(instrument_id, threshold, window_size));
+                }
+            }});
+        }
+    }
+}
+
+std::vector<SweepResult> ParameterSweep::run(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<SweepResult> results(cases_.size());
+    auto run_case = [this, &results](size_t index) {
+        BacktestEngine engine(config_);
+        cases_[index].setup(engine);
+        for (const TickSpan& span : spans_) {
+            engine.run(span.ticks, span.count);
+        }
+        results[index] = {cases_[index].label, engine.getStats()};
+    };
+
+    // The calling thread takes part, so the pool needs one thread fewer
+    const SystemConfig& config = ConfigManager::getInstance();
+    ThreadPool pool(thread_count - 1, config.market_data_wait_strategy, config.spin_iterations);
+    pool.parallelFor(cases_.size(), run_case);
+    return results;
+}
+
+void ParameterSweep::printTable(std::ostream& out, std::vector<SweepResult> results) {
+    std::sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        return a.stats.total_pnl > b.stats.total_pnl;
+    });
+
+    size_t label_width = 5;
+    for (const auto& result : results) {
+        label_width = std::max(label_width, result.label.size());
+    }
+
+    out << std::left << std::setw(static_cast<int>(label_width)) << "case" << std::right
+        << std::setw(10) << "signals" << std::setw(10) << "fills" << std::setw(10) << "trades"
+        << std::setw(8) << "win%" << std::setw(14) << "realized" << std::setw(14) << "unrealized"
+        << std::setw(14) << "total" << std::setw(14) << "max_dd" << std::setw(12) << "Mticks/s" << "\n";
+
+    for (const auto& result : results) {
+        const BacktestStats& stats = result.stats;
+        out << std::left << std::setw(static_cast<int>(label_width)) << result.label << std::right
+            << std::setw(10) << stats.signals << std::setw(10) << stats.fills
+            << std::setw(10) << stats.closing_trades
+            << std::fixed << std::setprecision(1) << std::setw(8) << 100.0 * stats.winRate()
+            << std::setprecision(2) << std::setw(14) << stats.realized_pnl
+            << std::setw(14) << stats.unrealized_pnl << std::setw(14) << stats.total_pnl
+            << std::setw(14) << stats.max_drawdown
+            << std::setw(12) << stats.ticks_per_second / 1e6 << "\n";
+        out.unsetf(std::ios::fixed);
+    }
+}
@@ -1,10 +1,15 @@
 #include "../include/risk_management.h"
+#include "../include/last_value_cache.h"
+#include "../include/clock.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 
-RiskManagement::RiskManagement() {
-    last_second_check_ = std::chrono::steady_clock::now();
+RiskManagement::RiskManagement()
+    : quotes_(&LastValueCache::getInstance()),
+      specs_(InstrumentSpecs::getInstance()),
+      log_rejections_(ConfigManager::getInstance().enable_logging) {
+    last_second_check_ = Clock::now();
 }
 
 RiskManagement::~RiskManagement() {
@@ -24,17 +29,26 @@ bool RiskManagement::checkOrder(const Order& order) {
     
     // Check all risk limits
     if (!checkPositionSize(order)) {
-        std::cout << "Risk check failed: Position size limit exceeded" << std::endl;
+        orders_rejected_++;
+        if (log_rejections_) {
+            std::cout << "Risk check failed: Position size limit exceeded" << std::endl;
+        }
         return false;
     }
     
     if (!checkOrderValue(order)) {
-        std::cout << "Risk check failed: Order value limit exceeded" << std::endl;
+        orders_rejected_++;
+        if (log_rejections_) {
+            std::cout << "Risk check failed: Order value limit exceeded" << std::endl;
+        }
         return false;
     }
     
     if (!checkRateOfOrders(order)) {
-        std::cout << "Risk check failed: Too many orders per second" << std::endl;
+        orders_rejected_++;
+        if (log_rejections_) {
+            std::cout << "Risk check failed: Too many orders per second" << std::endl;
+        }
         return false;
     }
     
@@ -50,20 +64,12 @@ void RiskManagement::updatePosition(const Order& order) {
     
     auto& position = positions_[order.instrument_id];
     position.instrument_id = order.instrument_id;
-    position.last_update = std::chrono::system_clock::now();
+    position.last_update = Clock::now();
     
-    // Update quantity based on order side
-    if (order.side == OrderSide::BUY) {
-        position.quantity += order.filled_quantity;
-    } else {
-        position.quantity -= order.filled_quantity;
-    }
-    
-    // Update average price
-    if (position.quantity != 0) {
-        position.average_price = ((position.average_price * (position.quantity - order.filled_quantity)) + 
-                                 (order.price * order.filled_quantity)) / position.quantity;
-    }
+    // Exact integer bookkeeping, so the result does not depend on the
+    // order in which fills are summed
+    int64_t lots = order.filled_quantity.count();
+    position.applyFill(order.side == OrderSide::BUY ? lots : -lots, order.price);
 }
 
 Position RiskManagement::getPosition(InstrumentId instrument_id) const {
@@ -71,10 +77,41 @@ Position RiskManagement::getPosition(InstrumentId instrument_id) const {
     
     auto it = positions_.find(instrument_id);
     if (it != positions_.end()) {
-        return it->second;
+        Position position = it->second;
+        markPosition(position);
+        return position;
+    }
+    
+    return {instrument_id, 0, 0, 0, 0.0, Clock::now()};
+}
+
+void RiskManagement::markToMarket() {
+    std::lock_guard<std::mutex> lock(positions_mutex_);
+    
+    double total_value = 0.0;
+    for (auto& pair : positions_) {
+        markPosition(pair.second);
+        InstrumentSpec spec = specs_.getSpec(pair.first);
+        total_value += static_cast<double>(pair.second.quantity) * quotes_->getMidPrice(pair.first) *
+                       spec.tick_size * spec.lot_size;
     }
     
-    return {instrument_id, 0.0, 0.0, 0.0, 0.0, std::chrono::system_clock::now()};
+    total_portfolio_value_ = total_value;
+}
+
+void RiskManagement::markPosition(Position& position) const {
+    if (position.quantity == 0) {
+        position.unrealized_pnl = 0.0;
+        return;
+    }
+    double mid = quotes_->getMidPrice(position.instrument_id);
+    if (mid > 0) {
+        position.unrealized_pnl = mid * static_cast<double>(position.quantity) - static_cast<double>(position.cost);
+    }
+}
+
+void RiskManagement::setQuoteSource(const LastValueCache* quotes) {
+    quotes_ = quotes ? quotes : &LastValueCache::getInstance();
 }
 
 double RiskManagement::getTotalValue() const {
@@ -86,7 +123,7 @@ void RiskManagement::resetDailyStats() {
     daily_pnl_ = 0.0;
     current_drawdown_ = 0.0;
     orders_last_second_ = 0;
-    last_second_check_ = std::chrono::steady_clock::now();
+    last_second_check_ = Clock::now();
 }
 
 double RiskManagement::calculateVaR(InstrumentId instrument_id, double quantity) {
@@ -99,13 +136,13 @@ bool RiskManagement::checkPositionSize(const Order& order) {
     std::lock_guard<std::mutex> lock(positions_mutex_);
     
     auto it = positions_.find(order.instrument_id);
-    double current_pos = (it != positions_.end()) ? it->second.quantity : 0.0;
+    int64_t current_pos = (it != positions_.end()) ? it->second.quantity : 0;
     
-    double new_quantity = (order.side == OrderSide::BUY) ? 
-                         current_pos + order.quantity : 
-                         current_pos - order.quantity;
+    int64_t new_quantity = (order.side == OrderSide::BUY) ? 
+                          current_pos + order.quantity.count() : 
+                          current_pos - order.quantity.count();
     
-    return std::abs(new_quantity) <= risk_limits_.max_position_size;
+    return std::abs(positionSize(order.instrument_id, new_quantity)) <= risk_limits_.max_position_size;
 }
 
 bool RiskManagement::checkDailyLoss() {
@@ -114,7 +151,17 @@ bool RiskManagement::checkDailyLoss() {
 }
 
 bool RiskManagement::checkOrderValue(const Order& order) {
-    double order_value = order.price * order.quantity;
+    // Market orders execute at the prevailing quote, not at their own price
+    Price price = order.price;
+    Tick quote;
+    if (order.type == OrderType::MARKET && quotes_->get(order.instrument_id, quote)) {
+        Price touch = (order.side == OrderSide::BUY) ? quote.ask_price : quote.bid_price;
+        if (touch.count() > 0) {
+            price = touch;
+        }
+    }
+    
+    double order_value = specs_.getSpec(order.instrument_id).toValue(notional(price, order.quantity));
     return order_value <= risk_limits_.max_order_value;
 }
 
@@ -124,10 +171,8 @@ bool RiskManagement::checkDrawdown() {
 }
 
 bool RiskManagement::checkRateOfOrders(const Order& order) {
-    auto now = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - last_second_check_).count();
-    
-    if (duration >= 1) {
+    auto now = Clock::now();
+    if (now - last_second_check_ >= 1000000000ULL) {
         // Reset counter if more than a second has passed
         orders_last_second_ = 1;
         last_second_check_ = now;
@@ -139,5 +184,5 @@ bool RiskManagement::checkRateOfOrders(const Order& order) {
 }
 
 bool RiskManagement::checkPosition(const Position& position) {
-    return std::abs(position.quantity) <= risk_limits_.max_position_size;
+    return std::abs(positionSize(position.instrument_id, position.quantity)) <= risk_limits_.max_position_size;
 }
\ No newline at end of file
@@ -1,11 +1,33 @@
 #include "../include/strategy_engine.h"
+#include "../include/clock.h"
+#include "../include/instrument_spec.h"
 #include <iostream>
-#include <numeric>
+#include <cmath>
+#include <algorithm>
 
-StrategyEngine::StrategyEngine() = default;
+StrategyEngine::StrategyEngine()
+    : StrategyEngine(ConfigManager::getInstance().strategy_threads) {}
+
+StrategyEngine::StrategyEngine(size_t strategy_threads)
+    : routes_(ConfigManager::getInstance().max_instruments),
+      wildcard_(new RouteList()) {
+    const SystemConfig& config = ConfigManager::getInstance();
+    if (strategy_threads > 0) {
+        thread_pool_ = std::make_unique<ThreadPool>(strategy_threads,
+                                                    config.market_data_wait_strategy,
+                                                    config.spin_iterations);
+    }
+}
 
 StrategyEngine::~StrategyEngine() {
     stop();
+    
+    // No dispatch can be running any more; free the published lists, the
+    // reclaimer and slots_ free the rest
+    routes_.forEach([](InstrumentId, std::atomic<const RouteList*>& route) {
+        delete route.load(std::memory_order_relaxed);
+    });
+    delete wildcard_.load(std::memory_order_relaxed);
 }
 
 bool StrategyEngine::initialize(SignalCallback callback) {
@@ -22,11 +44,160 @@ bool StrategyEngine::registerStrategy(std::unique_ptr<Strategy> strategy) {
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(strategies_mutex_);
-    strategies_.push_back(std::move(strategy));
+    std::vector<InstrumentId> instruments = strategy->getInstruments();
+    for (InstrumentId instrument_id : instruments) {
+        if (instrument_id >= routes_.maxInstruments()) {
+            std::cerr << "Strategy " << strategy->getName() << " requested out-of-range instrument "
+                      << instrument_id << std::endl;
+            return false;
+        }
+    }
+    std::sort(instruments.begin(), instruments.end());
+    instruments.erase(std::unique(instruments.begin(), instruments.end()), instruments.end());
+    
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto slot = std::make_unique<StrategySlot>();
+    slot->strategy = std::move(strategy);
+    slot->sequence = next_sequence_++;
+    slot->sink.setStrategyId(static_cast<StrategyId>(slot->sequence + 1));
+    slot->instruments = std::move(instruments);
+    StrategySlot* added = slot.get();
+    
+    // New strategies have the highest sequence, so appending keeps every
+    // list in registration order
+    const RouteList* wildcard = wildcard_.load(std::memory_order_relaxed);
+    if (added->instruments.empty()) {
+        // Wildcard strategies join every specific route as well
+        routes_.forEach([this, added](InstrumentId, std::atomic<const RouteList*>& route) {
+            const RouteList* current = route.load(std::memory_order_relaxed);
+            if (current) {
+                auto list = new RouteList(*current);
+                list->push_back(added);
+                publish(route, list);
+            }
+        });
+        auto list = new RouteList(*wildcard);
+        list->push_back(added);
+        publish(wildcard_, list);
+    } else {
+        for (InstrumentId instrument_id : added->instruments) {
+            std::atomic<const RouteList*>* route = routes_.getOrCreate(instrument_id);
+            const RouteList* current = route->load(std::memory_order_relaxed);
+            auto list = new RouteList(current ? *current : *wildcard);
+            list->push_back(added);
+            publish(*route, list);
+        }
+    }
+    
+    slots_.push_back(std::move(slot));
+    reclaimer_.reclaim();
     return true;
 }
 
+bool StrategyEngine::unregisterStrategy(Strategy* strategy) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return unregisterSlot(findSlot(strategy));
+}
+
+bool StrategyEngine::unregisterStrategy(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return unregisterSlot(findSlot(name));
+}
+
+bool StrategyEngine::unregisterSlot(StrategySlot* slot) {
+    if (!slot) {
+        return false;
+    }
+    
+    auto without = [slot](const RouteList& current) {
+        auto list = new RouteList();
+        list->reserve(current.size());
+        for (StrategySlot* other : current) {
+            if (other != slot) {
+                list->push_back(other);
+            }
+        }
+        return list;
+    };
+    
+    // A route keeps its list once specific, it still carries the wildcards
+    if (slot->instruments.empty()) {
+        routes_.forEach([this, &without](InstrumentId, std::atomic<const RouteList*>& route) {
+            const RouteList* current = route.load(std::memory_order_relaxed);
+            if (current) {
+                publish(route, without(*current));
+            }
+        });
+        publish(wildcard_, without(*wildcard_.load(std::memory_order_relaxed)));
+    } else {
+        for (InstrumentId instrument_id : slot->instruments) {
+            std::atomic<const RouteList*>* route = routes_.find(instrument_id);
+            publish(*route, without(*route->load(std::memory_order_relaxed)));
+        }
+    }
+    
+    // Dispatches that loaded the old lists may still be running the strategy
+    auto it = std::find_if(slots_.begin(), slots_.end(),
+                           [slot](const std::unique_ptr<StrategySlot>& owned) { return owned.get() == slot; });
+    reclaimer_.retireObject(it->release());
+    slots_.erase(it);
+    reclaimer_.reclaim();
+    return true;
+}
+
+bool StrategyEngine::pauseStrategy(Strategy* strategy) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return setPaused(findSlot(strategy), true);
+}
+
+bool StrategyEngine::pauseStrategy(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return setPaused(findSlot(name), true);
+}
+
+bool StrategyEngine::resumeStrategy(Strategy* strategy) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return setPaused(findSlot(strategy), false);
+}
+
+bool StrategyEngine::resumeStrategy(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return setPaused(findSlot(name), false);
+}
+
+bool StrategyEngine::setPaused(StrategySlot* slot, bool paused) {
+    if (!slot) {
+        return false;
+    }
+    
+    // Dispatch checks the flag per strategy, so this applies from the next event
+    slot->paused.store(paused, std::memory_order_release);
+    return true;
+}
+
+StrategyEngine::StrategySlot* StrategyEngine::findSlot(const Strategy* strategy) const {
+    for (const auto& slot : slots_) {
+        if (slot->strategy.get() == strategy) {
+            return slot.get();
+        }
+    }
+    return nullptr;
+}
+
+StrategyEngine::StrategySlot* StrategyEngine::findSlot(const std::string& name) const {
+    for (const auto& slot : slots_) {
+        if (slot->strategy->getName() == name) {
+            return slot.get();
+        }
+    }
+    return nullptr;
+}
+
+void StrategyEngine::publish(std::atomic<const RouteList*>& target, RouteList* list) {
+    const RouteList* previous = target.exchange(list, std::memory_order_acq_rel);
+    reclaimer_.retireObject(previous);
+}
+
 void StrategyEngine::start() {
     running_ = true;
 }
@@ -40,19 +211,108 @@ void StrategyEngine::processTick(const Tick& tick) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(strategies_mutex_);
+    std::lock_guard<std::mutex> lock(dispatch_mutex_);
+    EpochReclaimer::Guard guard(reclaimer_);
+    if (thread_pool_) {
+        dispatchParallel(&tick, 1);
+    } else {
+        dispatchTick(tick);
+    }
+}
+
+void StrategyEngine::processTicks(const Tick* ticks, size_t count) {
+    if (!running_ || count == 0) {
+        return;
+    }
     
-    for (auto& strategy : strategies_) {
-        if (strategy->isActive()) {
+    std::lock_guard<std::mutex> lock(dispatch_mutex_);
+    EpochReclaimer::Guard guard(reclaimer_);
+    if (thread_pool_) {
+        dispatchParallel(ticks, count);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        dispatchTick(ticks[i]);
+    }
+}
+
+void StrategyEngine::dispatchTick(const Tick& tick) {
+    for (StrategySlot* slot : routeFor(tick.instrument_id)) {
+        Strategy* strategy = slot->strategy.get();
+        if (!slot->paused.load(std::memory_order_acquire) && strategy->isActive()) {
             strategy->onTick(tick);
             
-            // Check for any generated signals
-            auto signals = strategy->generateSignals();
-            for (const auto& signal : signals) {
-                if (signal_callback_) {
+            // Drain any signals emitted for this tick
+            SignalSink& sink = slot->sink;
+            strategy->emitSignals(sink);
+            if (signal_callback_) {
+                for (const auto& signal : sink) {
                     signal_callback_(signal);
                 }
             }
+            sink.clear();
+        }
+    }
+}
+
+void StrategyEngine::dispatchParallel(const Tick* ticks, size_t count) {
+    // Hand each interested strategy the batch indices of its ticks, in order
+    batch_strategies_.clear();
+    for (size_t i = 0; i < count; ++i) {
+        for (StrategySlot* slot : routeFor(ticks[i].instrument_id)) {
+            if (slot->paused.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (slot->ticks.empty()) {
+                batch_strategies_.push_back(slot);
+            }
+            slot->ticks.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    
+    // A strategy only ever runs on one thread at a time and sees its ticks in order
+    thread_pool_->parallelFor(batch_strategies_.size(), [this, ticks](size_t n) {
+        StrategySlot* slot = batch_strategies_[n];
+        Strategy* strategy = slot->strategy.get();
+        
+        for (uint32_t tick_index : slot->ticks) {
+            if (strategy->isActive()) {
+                strategy->onTick(ticks[tick_index]);
+                strategy->emitSignals(slot->sink);
+                for (const auto& signal : slot->sink) {
+                    slot->signals.push_back({tick_index, slot->sequence, 0, signal});
+                }
+                slot->sink.clear();
+            }
+        }
+    });
+    
+    merged_signals_.clear();
+    for (StrategySlot* slot : batch_strategies_) {
+        for (auto& pending : slot->signals) {
+            pending.emit_index = static_cast<uint32_t>(merged_signals_.size());
+            merged_signals_.push_back(pending);
+        }
+        slot->signals.clear();
+        slot->ticks.clear();
+    }
+    
+    // Same order as the serial path: by tick, then by registration, then by
+    // emission. Keys are unique, so the in-place sort needs no scratch buffer.
+    std::sort(merged_signals_.begin(), merged_signals_.end(),
+              [](const PendingSignal& a, const PendingSignal& b) {
+                  if (a.tick_index != b.tick_index) {
+                      return a.tick_index < b.tick_index;
+                  }
+                  if (a.sequence != b.sequence) {
+                      return a.sequence < b.sequence;
+                  }
+                  return a.emit_index < b.emit_index;
+              });
+    
+    if (signal_callback_) {
+        for (const auto& pending : merged_signals_) {
+            signal_callback_(pending.order);
         }
     }
 }
@@ -62,21 +322,23 @@ void StrategyEngine::processOrderUpdate(const Order& order) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(strategies_mutex_);
+    std::lock_guard<std::mutex> lock(dispatch_mutex_);
+    EpochReclaimer::Guard guard(reclaimer_);
     
-    for (auto& strategy : strategies_) {
-        if (strategy->isActive()) {
+    for (StrategySlot* slot : routeFor(order.instrument_id)) {
+        Strategy* strategy = slot->strategy.get();
+        if (!slot->paused.load(std::memory_order_acquire) && strategy->isActive()) {
             strategy->onOrderUpdate(order);
         }
     }
 }
 
 size_t StrategyEngine::getActiveStrategiesCount() const {
-    std::lock_guard<std::mutex> lock(strategies_mutex_);
+    std::lock_guard<std::mutex> lock(registry_mutex_);
     
     size_t count = 0;
-    for (const auto& strategy : strategies_) {
-        if (strategy->isActive()) {
+    for (const auto& slot : slots_) {
+        if (!slot->paused.load(std::memory_order_relaxed) && slot->strategy->isActive()) {
             count++;
         }
     }
@@ -84,35 +346,45 @@ size_t StrategyEngine::getActiveStrategiesCount() const {
     return count;
 }
 
+size_t StrategyEngine::getStrategyCount() const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return slots_.size();
+}
+
 Strategy* StrategyEngine::getStrategyByName(const std::string& name) {
-    std::lock_guard<std::mutex> lock(strategies_mutex_);
-    
-    for (auto& strategy : strategies_) {
-        if (strategy->getName() == name) {
-            return strategy.get();
-        }
-    }
-    
-    return nullptr;
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    StrategySlot* slot = findSlot(name);
+    return slot ? slot->strategy.get() : nullptr;
+}
+
+bool StrategyEngine::isPaused(Strategy* strategy) const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    StrategySlot* slot = findSlot(strategy);
+    return slot && slot->paused.load(std::memory_order_relaxed);
+}
+
+StrategyId StrategyEngine::getStrategyId(Strategy* strategy) const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    StrategySlot* slot = findSlot(strategy);
+    return slot ? slot->sink.getStrategyId() : 0;
 }
 
 // Implementation for SimpleMeanReversionStrategy
-SimpleMeanReversionStrategy::SimpleMeanReversionStrategy(InstrumentId instrument_id, double threshold)
-    : instrument_id_(instrument_id), threshold_(threshold) {}
+SimpleMeanReversionStrategy::SimpleMeanReversionStrategy(InstrumentId instrument_id, double threshold, size_t window_size)
+    : instrument_id_(instrument_id),
+      threshold_(threshold),
+      order_quantity_(InstrumentSpecs::getInstance().toQuantity(instrument_id, 100.0)),
+      mid_prices_(window_size) {}
 
 void SimpleMeanReversionStrategy::onTick(const Tick& tick) {
     if (tick.instrument_id != instrument_id_) {
         return;
     }
     
-    // Add the price to our price history
-    Price mid_price = (tick.bid_price + tick.ask_price) / 2.0;
-    prices_.push_back(mid_price);
-    
-    // Keep only the last N prices
-    if (prices_.size() > window_size_) {
-        prices_.erase(prices_.begin());
-    }
+    // Add the price to the rolling window, evicting the oldest once full.
+    // Deviations are relative, so the mean can stay in ticks.
+    mid_prices_.push(static_cast<int64_t>(tick.bid_price.count()) + tick.ask_price.count());
+    has_new_price_ = true;
 }
 
 void SimpleMeanReversionStrategy::onOrderUpdate(const Order& order) {
@@ -124,45 +396,48 @@ void SimpleMeanReversionStrategy::onOrderUpdate(const Order& order) {
     last_order_state_ = order.state;
 }
 
-std::vector<Order> SimpleMeanReversionStrategy::generateSignals() {
-    std::vector<Order> signals;
+void SimpleMeanReversionStrategy::emitSignals(SignalSink& sink) {
+    if (!has_new_price_) {
+        return; // Tick was for another instrument
+    }
+    has_new_price_ = false;
     
-    if (prices_.size() < 2) {
-        return signals; // Not enough data yet
+    if (mid_prices_.size() < 2) {
+        return; // Not enough data yet
     }
     
-    // Calculate simple moving average
-    double sum = std::accumulate(prices_.begin(), prices_.end(), 0.0);
-    double sma = sum / prices_.size();
+    // Simple moving average, maintained incrementally
+    double sma = mid_prices_.mean() / 2.0;
     
     // Current price (using mid-price)
-    Price current_price = prices_.back();
+    double current_price = mid_prices_.last() / 2.0;
     
     // Check if price deviates significantly from SMA
     double deviation = (current_price - sma) / sma;
     
     // Only generate signals if deviation exceeds threshold and no active order
     if (std::abs(deviation) > threshold_ && 
-        (last_order_state_ == OrderState::FILLED || last_order_state_ == OrderState::CANCELLED || last_order_id_ == 0)) {
+        (last_order_state_ == OrderState::FILLED || last_order_state_ == OrderState::CANCELLED ||
+         last_order_state_ == OrderState::REJECTED || last_order_id_ == 0)) {
         
         Order signal;
         signal.instrument_id = instrument_id_;
         signal.type = OrderType::MARKET;
-        signal.quantity = 100; // Fixed quantity for simplicity
-        signal.timestamp = std::chrono::high_resolution_clock::now();
+        signal.quantity = order_quantity_;
+        signal.timestamp = Clock::now();
         
+        // The mid rounded onto the tick grid
+        Price price(static_cast<Price::Rep>(std::lround(current_price)));
         if (deviation > threshold_) {
             // Price is above SMA - sell (mean reversion)
             signal.side = OrderSide::SELL;
-            signal.price = current_price;
+            signal.price = price;
         } else if (deviation < -threshold_) {
             // Price is below SMA - buy (mean reversion)
             signal.side = OrderSide::BUY;
-            signal.price = current_price;
+            signal.price = price;
         }
         
-        signals.push_back(signal);
+        sink.emit(signal);
     }
-    
-    return signals;
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "../include/thread_pool.h"
+
+void ThreadPool::WorkQueue::push(const Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == tasks.size()) {
+        // Grow by unrolling the ring into a larger buffer
+        std::vector<Task> grown(tasks.empty() ? 64 : tasks.size() * 2);
+        for (size_t i = 0; i < count; ++i) {
+            grown[i] = tasks[(head + i) % tasks.size()];
+        }
+        tasks.swap(grown);
+        head = 0;
+    }
+    tasks[(head + count) % tasks.size()] = task;
+    ++count;
+}
+
+bool ThreadPool::WorkQueue::popBack(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) {
+        return false;
+    }
+    --count;
+    task = tasks[(head + count) % tasks.size()];
+    return true;
+}
+
+bool ThreadPool::WorkQueue::popFront(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) {
+        return false;
+    }
+    task = tasks[head];
+    head = (head + 1) % tasks.size();
+    --count;
+    return true;
+}
+
+ThreadPool::ThreadPool(size_t thread_count, WaitStrategy wait_strategy, uint32_t spin_iterations) {
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>(wait_strategy, spin_iterations));
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_[i]->thread = std::thread(&ThreadPool::workerThread, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    running_ = false;
+    for (auto& worker : workers_) {
+        worker->waiter.notify();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void ThreadPool::run(size_t count, TaskFn fn, void* context) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t self = workers_.size();
+    if (count == 1 || workers_.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(context, i);
+        }
+        tasks_executed_.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    pending_.store(count, std::memory_order_relaxed);
+
+    // Deal tasks round-robin across every queue, the caller's included
+    size_t queues = workers_.size() + 1;
+    for (size_t i = 0; i < count; ++i) {
+        queued_.fetch_add(1, std::memory_order_release);
+        queueOf(i % queues).push({fn, context, i});
+    }
+    for (auto& worker : workers_) {
+        worker->waiter.notify();
+    }
+
+    // Help out until every task has finished
+    Task task;
+    while (pending_.load(std::memory_order_acquire) > 0) {
+        if (findTask(self, task)) {
+            execute(task);
+        } else {
+            cpuRelax();
+        }
+    }
+}
+
+void ThreadPool::workerThread(size_t self) {
+    Worker& worker = *workers_[self];
+    Task task;
+
+    while (running_) {
+        if (findTask(self, task)) {
+            worker.waiter.reset();
+            execute(task);
+        } else {
+            worker.waiter.wait([this] {
+                return queued_.load(std::memory_order_acquire) > 0 || !running_;
+            });
+        }
+    }
+}
+
+bool ThreadPool::findTask(size_t self, Task& task) {
+    if (queued_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    if (queueOf(self).popBack(task)) {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Own queue is empty, steal the oldest task from someone else
+    size_t queues = workers_.size() + 1;
+    for (size_t offset = 1; offset < queues; ++offset) {
+        if (queueOf((self + offset) % queues).popFront(task)) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            tasks_stolen_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(const Task& task) {
+    task.fn(task.context, task.index);
+    tasks_executed_.fetch_add(1, std::memory_order_relaxed);
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+}
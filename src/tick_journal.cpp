@@ -0,0 +1,115 @@
+#include "../include/tick_journal.h"
+#include "../include/market_data_handler.h"
+#include "../include/clock.h"
+#include <iostream>
+#include <chrono>
+
+TickJournalWriter::TickJournalWriter(const std::string& path_prefix, size_t segment_size, size_t queue_capacity)
+    : journal_(path_prefix, sizeof(Tick), segment_size),
+      ring_(queue_capacity),
+      waiter_(WaitStrategy::SPIN_THEN_PARK, 1000) {}
+
+TickJournalWriter::~TickJournalWriter() {
+    stop();
+}
+
+bool TickJournalWriter::start() {
+    if (running_) {
+        return true;
+    }
+
+    if (!journal_.open()) {
+        return false;
+    }
+
+    running_ = true;
+    writer_thread_ = std::make_unique<std::thread>(&TickJournalWriter::writerThread, this);
+    return true;
+}
+
+void TickJournalWriter::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    waiter_.notify();
+    if (writer_thread_ && writer_thread_->joinable()) {
+        writer_thread_->join();
+    }
+
+    // Anything queued after the writer exited
+    drain();
+    journal_.close();
+}
+
+void TickJournalWriter::writerThread() {
+    while (running_) {
+        if (drain() > 0) {
+            waiter_.reset();
+            continue;
+        }
+
+        waiter_.wait([this] { return !ring_.empty() || !running_; });
+    }
+}
+
+size_t TickJournalWriter::drain() {
+    Tick tick;
+    size_t written = 0;
+
+    while (ring_.tryPop(tick)) {
+        if (!journal_.append(&tick)) {
+            ticks_dropped_++;
+            continue;
+        }
+        ++written;
+    }
+
+    if (written > 0) {
+        journal_.publish();
+        ticks_recorded_ += written;
+    }
+    return written;
+}
+
+TickJournalReader::TickJournalReader(const std::string& path_prefix)
+    : journal_(path_prefix, sizeof(Tick)) {}
+
+uint64_t replayTickJournal(const TickJournalReader& reader, MarketDataHandler& handler, double speed) {
+    uint64_t accepted = 0;
+    bool first = true;
+    Timestamp first_tick_time = 0;
+    Timestamp replay_start = 0;
+
+    reader.forEach([&](const Tick& tick) {
+        // Original timing comes from the exchange, or from capture time if absent
+        Timestamp tick_time = tick.exchange_timestamp ? tick.exchange_timestamp : tick.receive_timestamp;
+
+        if (speed > 0.0) {
+            if (first) {
+                first_tick_time = tick_time;
+                replay_start = Clock::now();
+                first = false;
+            } else if (tick_time > first_tick_time) {
+                // Wait until the scaled offset of this tick has elapsed
+                Timestamp due = replay_start + static_cast<Timestamp>((tick_time - first_tick_time) / speed);
+                Timestamp now = Clock::now();
+                if (due > now + 200000) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(due - now - 100000));
+                }
+                while (Clock::now() < due) {
+                    cpuRelax();
+                }
+            }
+        }
+
+        // Replayed ticks are re-stamped with their replay receive time, and
+        // not captured again if the handler is recording
+        if (handler.replayTick(tick, Clock::now())) {
+            ++accepted;
+        }
+        return true;
+    });
+
+    return accepted;
+}